@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lazy.h"
+#include "pairing.h"
+#include "dary.h"
+#include "bheap.h"
+#include "leftist.h"
+#include "radix.h"
+#include "eager.h"
+#include "sorted.h"
+#include "unsorted.h"
+#include "bucket.h"
+
+// g++ -std=c++2b -O3 -DNDEBUG -o bench bench.cc
+// ./bench [n...] (defaults to 1000000 10000000)
+
+namespace
+{
+  std::size_t allocations = 0; ///< The number of global allocations made so far.
+}
+
+void *operator new(std::size_t size)
+{
+  ++allocations;
+  if (void *ptr = std::malloc(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+// not inlined, or GCC pairs the inlined free with operator new and warns of a mismatch
+[[gnu::noinline]] void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+  /**
+   * @brief Measures a single phase of a benchmark.
+   *
+   * Runs `body` once and prints its average time and number of global allocations per
+   * operation, where `ops` is the number of heap operations performed by `body`.
+   */
+  template <typename F>
+  void measure(const char *heap, const char *phase, std::size_t ops, F &&body)
+  {
+    const std::size_t allocations_before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    std::printf("%-24s %-12s n=%-11zu %9.2f ns/op %7.3f allocs/op\n", heap, phase, ops,
+                ns / ops, static_cast<double>(allocations - allocations_before) / ops);
+  }
+
+  /**
+   * @brief Inserts all keys into a fresh heap, then extracts all of them.
+   */
+  template <typename Heap>
+  void insert_then_extract(const char *name, const std::vector<int> &keys)
+  {
+    Heap heap{};
+    measure(name, "insert", keys.size(), [&]
+            { for (int key : keys) heap.insert(key); });
+    measure(name, "extract_min", keys.size(), [&]
+            { while (heap.extract_min()) {} });
+  }
+
+  /**
+   * @brief Bulk loads all keys into a fresh heap, then extracts all of them.
+   */
+  template <typename Heap>
+  void insert_range_then_extract(const char *name, const std::vector<int> &keys)
+  {
+    Heap heap{};
+    measure(name, "insert_range", keys.size(), [&]
+            { heap.insert_range(keys); });
+    measure(name, "extract_min", keys.size(), [&]
+            { while (heap.extract_min()) {} });
+  }
+
+  /**
+   * @brief Fills a fresh heap, then alternates extractions and insertions at a steady size.
+   *
+   * This is the access pattern of event simulations and of Dijkstra-like searches, where
+   * every extracted key is soon followed by new keys.
+   */
+  template <typename Heap>
+  void steady_state(const char *name, const std::vector<int> &keys)
+  {
+    Heap heap{};
+    heap.insert_range(keys);
+    measure(name, "extract+ins", keys.size(), [&]
+            { for (int key : keys) { heap.extract_min(); heap.insert(key); } });
+  }
+
+  /**
+   * @brief Like `steady_state`, but every inserted key is at least the extracted minimum.
+   *
+   * This is the access pattern of Dijkstra's algorithm and of event loops, for which
+   * monotone heaps such as `RadixHeap` are designed. The keys are 64-bit unsigned integers.
+   */
+  template <typename Heap>
+  void monotone_steady_state(const char *name, const std::vector<int> &keys)
+  {
+    Heap heap{};
+    for (int key : keys)
+    {
+      heap.insert(static_cast<std::uint32_t>(key) >> 8);
+    }
+    measure(name, "monotone", keys.size(), [&]
+            { for (int key : keys) { heap.insert(*heap.extract_min() + (static_cast<std::uint32_t>(key) & 0xffff)); } });
+  }
+
+  /**
+   * @brief Like `steady_state`, but the keys are small priorities in [0, 4096).
+   *
+   * This is the access pattern of schedulers and of shortest paths with small integer
+   * weights, for which bucket queues such as `BucketQueue` are designed.
+   */
+  template <typename Heap>
+  void small_priority_steady_state(const char *name, const std::vector<int> &keys)
+  {
+    Heap heap{};
+    for (int key : keys)
+    {
+      heap.insert(key & 4095);
+    }
+    measure(name, "small prio", keys.size(), [&]
+            { for (int key : keys) { heap.extract_min(); heap.insert(key & 4095); } });
+  }
+
+  /**
+   * @brief Returns a new `PolymorphicHeap` wrapping a `Heap`, behind the virtual interface.
+   *
+   * The function is never inlined, so the compiler cannot see the dynamic type of the heap
+   * and has to dispatch every operation through the virtual table.
+   */
+  template <typename Heap>
+  [[gnu::noinline]] std::unique_ptr<MergeableHeap<int>> make_polymorphic()
+  {
+    return std::make_unique<PolymorphicHeap<Heap>>();
+  }
+
+  /**
+   * @brief Measures the cost of virtual dispatch per operation.
+   *
+   * Runs the small-priority steady state on a small heap of 1024 keys, once calling the
+   * concrete heap directly and once through the `MergeableHeap` interface. The heap is kept
+   * small so that the operations themselves are cheap, and the difference between the two
+   * runs is the cost of the indirect calls and of the lost inlining.
+   */
+  template <typename Heap>
+  void dispatch_overhead(const char *name, const std::vector<int> &keys)
+  {
+    constexpr std::size_t heap_size = 1024;
+    const std::size_t ops = keys.size() - std::min(keys.size(), heap_size);
+
+    Heap direct{};
+    for (std::size_t i = 0; i < keys.size() - ops; ++i)
+    {
+      direct.insert(keys[i] & 4095);
+    }
+    measure(name, "direct", ops, [&]
+            { for (std::size_t i = keys.size() - ops; i < keys.size(); ++i) { direct.extract_min(); direct.insert(keys[i] & 4095); } });
+
+    std::unique_ptr<MergeableHeap<int>> virtual_heap = make_polymorphic<Heap>();
+    for (std::size_t i = 0; i < keys.size() - ops; ++i)
+    {
+      virtual_heap->insert(keys[i] & 4095);
+    }
+    measure(name, "virtual", ops, [&]
+            { for (std::size_t i = keys.size() - ops; i < keys.size(); ++i) { virtual_heap->extract_min(); virtual_heap->insert(keys[i] & 4095); } });
+  }
+
+  /**
+   * @brief Builds many shard heaps, merges them into one, then extracts the minimum once.
+   *
+   * Reports the cost of every merge and of the first extraction after them, which is where
+   * lazily merged heaps pay for their deferred work.
+   */
+  template <typename Heap>
+  void merge_shards(const char *name, const std::vector<int> &keys)
+  {
+    constexpr std::size_t shard_count = 256;
+    const std::size_t shard_size = keys.size() / shard_count;
+    std::vector<std::unique_ptr<Heap>> shards;
+    for (std::size_t i = 0; i < shard_count; ++i)
+    {
+      auto shard = std::make_unique<Heap>();
+      shard->insert_range(keys.begin() + i * shard_size, keys.begin() + (i + 1) * shard_size);
+      shards.push_back(std::move(shard));
+    }
+
+    Heap heap{};
+    measure(name, "merge", shard_count, [&]
+            { for (auto &shard : shards) heap.merge(*shard); });
+    measure(name, "extract_min", 1, [&]
+            { heap.extract_min(); });
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::vector<std::size_t> sizes{1'000'000, 10'000'000};
+  if (argc > 1)
+  {
+    sizes.clear();
+    for (int i = 1; i < argc; ++i)
+    {
+      sizes.push_back(std::stoull(argv[i]));
+    }
+  }
+
+  for (std::size_t n : sizes)
+  {
+    std::mt19937 rng(20407);
+    std::vector<int> keys(n);
+    for (int &key : keys)
+    {
+      key = static_cast<int>(rng());
+    }
+
+    insert_then_extract<LazyBinomialHeap<int>>("LazyBinomialHeap", keys);
+    insert_then_extract<PairingHeap<int>>("PairingHeap", keys);
+    insert_then_extract<ArrayDaryHeap<int>>("ArrayDaryHeap<4>", keys);
+    insert_then_extract<ArrayDaryHeap<int, 8>>("ArrayDaryHeap<8>", keys);
+    insert_then_extract<ArrayDaryHeap<int, 2>>("ArrayDaryHeap<2>", keys);
+    insert_then_extract<BHeap<int>>("BHeap", keys);
+    insert_then_extract<LeftistHeap<int>>("LeftistHeap", keys);
+    insert_then_extract<EagerBinomialHeap<int>>("EagerBinomialHeap", keys);
+    insert_range_then_extract<LazyBinomialHeap<int>>("LazyBinomialHeap", keys);
+    insert_range_then_extract<PairingHeap<int>>("PairingHeap", keys);
+    insert_range_then_extract<ArrayDaryHeap<int>>("ArrayDaryHeap<4>", keys);
+    steady_state<LazyBinomialHeap<int>>("LazyBinomialHeap", keys);
+    steady_state<PairingHeap<int>>("PairingHeap", keys);
+    steady_state<ArrayDaryHeap<int>>("ArrayDaryHeap<4>", keys);
+    steady_state<ArrayDaryHeap<int, 2>>("ArrayDaryHeap<2>", keys);
+    steady_state<BHeap<int>>("BHeap", keys);
+    steady_state<LeftistHeap<int>>("LeftistHeap", keys);
+    monotone_steady_state<RadixHeap<std::uint64_t>>("RadixHeap", keys);
+    monotone_steady_state<ArrayDaryHeap<std::uint64_t>>("ArrayDaryHeap<4>", keys);
+    monotone_steady_state<PairingHeap<std::uint64_t>>("PairingHeap", keys);
+    small_priority_steady_state<BucketQueue<int>>("BucketQueue", keys);
+    small_priority_steady_state<LazyBinomialHeap<int>>("LazyBinomialHeap", keys);
+    small_priority_steady_state<ArrayDaryHeap<int>>("ArrayDaryHeap<4>", keys);
+    dispatch_overhead<LazyBinomialHeap<int>>("LazyBinomialHeap", keys);
+    dispatch_overhead<PairingHeap<int>>("PairingHeap", keys);
+    dispatch_overhead<ArrayDaryHeap<int>>("ArrayDaryHeap<4>", keys);
+    dispatch_overhead<LeftistHeap<int>>("LeftistHeap", keys);
+    dispatch_overhead<EagerBinomialHeap<int>>("EagerBinomialHeap", keys);
+    dispatch_overhead<BucketQueue<int>>("BucketQueue", keys);
+    merge_shards<LazyBinomialHeap<int>>("LazyBinomialHeap", keys);
+    merge_shards<PairingHeap<int>>("PairingHeap", keys);
+    merge_shards<LeftistHeap<int>>("LeftistHeap", keys);
+    merge_shards<EagerBinomialHeap<int>>("EagerBinomialHeap", keys);
+    insert_range_then_extract<SortedLinkedHeap<int>>("SortedLinkedHeap", keys);
+
+    // a linear scan per extraction, so only on a prefix of the keys
+    const std::vector<int> prefix(keys.begin(), keys.begin() + std::min<std::size_t>(n, 20'000));
+    small_priority_steady_state<UnsortedLinkedHeap<int>>("UnsortedLinkedHeap", prefix);
+    small_priority_steady_state<BucketQueue<int>>("BucketQueue", prefix);
+  }
+}
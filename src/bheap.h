@@ -0,0 +1,552 @@
+#ifndef B_HEAP_H
+#define B_HEAP_H
+
+#include "mergeable_heap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class BHeap
+ *
+ * @brief An implicit binary heap whose nodes are grouped into page-sized subtrees.
+ *
+ * @details In a plain implicit heap, the parent of the key at index i is at index i / 2,
+ * so once the heap outgrows a few pages, every step of a sift touches a different page,
+ * and a root-to-leaf path of a large heap misses the TLB at almost every level. A B-heap
+ * (Poul-Henning Kamp, "You're Doing It Wrong") lays the same binary tree out in pages
+ * instead: every page holds a complete binary subtree of B - 1 keys, where B is the number
+ * of slots in a page, and the B / 2 leaves of that subtree have their 2 children each at
+ * the roots of B other pages. The pages themselves thus form an implicit B-ary tree, and a
+ * root-to-leaf path of log2 n keys touches only O(log n / log B) pages.
+ *
+ * Within a page, the root of the subtree is at slot 1, and the children of the key at slot
+ * i are at slots 2i and 2i + 1, like in a plain binary heap; slot 0 is left unused. The
+ * children of page p hang from its leaves in order: the children of the j-th leaf are the
+ * roots of pages B p + 2j + 1 and B p + 2j + 2. The pages are filled one after another,
+ * so the heap grows page by page, and the position of the k-th key in the array does not
+ * depend on the capacity of the array.
+ *
+ * The array is aligned to `PageSize` bytes where possible, so that every subtree occupies
+ * exactly one page of memory. Insertions and extractions move a "hole" along the path
+ * instead of swapping keys, so every step performs a single move.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method, and move-assignable, as it is moved along the
+ * heap in the sift operations.
+ * @tparam PageSize The size of a page in bytes, typically the page size of the operating
+ * system. `PageSize` must hold at least two keys.
+ * @tparam Allocator The allocator used to allocate the array.
+ */
+template <typename T, std::size_t PageSize = 4096, typename Allocator = std::allocator<T>>
+class BHeap final : public MergeableHeapBase<BHeap<T, PageSize, Allocator>, T>
+{
+  using Base = MergeableHeapBase<BHeap, T>; ///< The non-virtual base of the heap.
+  friend Base;
+
+  static_assert(PageSize >= 2 * sizeof(T), "A page of a B-heap must hold at least two keys");
+
+private:
+  using KeyAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using KeyTraits = std::allocator_traits<KeyAllocator>;
+
+  static constexpr std::size_t page_slots = std::bit_floor(PageSize / sizeof(T)); ///< The number of slots in a page.
+  static constexpr std::size_t page_keys = page_slots - 1;                        ///< The number of keys in a full page.
+  static constexpr std::size_t first_leaf = page_slots / 2;                       ///< The slot of the first leaf of a page.
+  static constexpr std::size_t min_pages = 1;                                     ///< The number of pages of the first allocation.
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * No memory is allocated until the first key is inserted.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr BHeap() : BHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its array using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the array.
+   */
+  constexpr explicit BHeap(const Allocator &alloc) noexcept : alloc(alloc), allocation(nullptr), slots(nullptr), size(0), pages(0) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the array.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr BHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : BHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr BHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return BHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr ~BHeap()
+  {
+    clear();
+    if (allocation != nullptr)
+    {
+      KeyTraits::deallocate(alloc, allocation, allocation_size(pages));
+    }
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The key is appended to the last page and sifted up to its place.
+   *
+   * The time complexity of this operation is O(log n) amortized, touching
+   * O(log n / log B) pages, where n is the number of keys in the heap.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly in its slot of the array.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    if (size == pages * page_keys)
+    {
+      reserve_pages(std::max(min_pages, 2 * pages));
+    }
+    const std::size_t slot = slot_of(size);
+    KeyTraits::construct(alloc, slots + slot, std::forward<Args>(args)...);
+    ++size;
+    sift_up(slot);
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The array is kept for later insertions.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap, or O(1) if `T` is trivially destructible.
+   */
+  constexpr void clear() noexcept
+  {
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      KeyTraits::destroy(alloc, slots + slot_of(k));
+    }
+    size = 0;
+  }
+
+  /**
+   * @brief Makes room for at least `new_capacity` keys.
+   *
+   * The time complexity of this operation is O(n) if the array is reallocated, where n is
+   * the number of keys in the heap, and O(1) otherwise.
+   *
+   * @param new_capacity The number of keys the heap should be able to hold without
+   * reallocating.
+   */
+  constexpr void reserve(std::size_t new_capacity)
+  {
+    reserve_pages((new_capacity + page_keys - 1) / page_keys);
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is the root.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+    return std::cref(slots[1]);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The root is moved out, and the last key of the last page is sifted down from the root.
+   *
+   * The time complexity of this operation is O(log n), touching O(log n / log B) pages,
+   * where n is the number of keys in the heap.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+
+    T key = std::move(slots[1]);
+    --size;
+    const std::size_t last = slot_of(size);
+    if (size > 0)
+    {
+      T moved = std::move(slots[last]);
+      sift_down(1, std::move(moved));
+    }
+    KeyTraits::destroy(alloc, slots + last);
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The arrays are swapped if the other heap holds more keys, so the smaller array is
+   * always the one being copied. Its keys are then appended, and the whole heap is
+   * heapified bottom-up.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the arrays may be swapped.
+   *
+   * The time complexity of this operation is O(n + m), where n and m are the number of
+   * keys in the two heaps.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(BHeap &other)
+  {
+    if (other.size > size)
+    {
+      std::swap(allocation, other.allocation);
+      std::swap(slots, other.slots);
+      std::swap(size, other.size);
+      std::swap(pages, other.pages);
+    }
+    if (other.size == 0)
+    {
+      return;
+    }
+
+    if (size + other.size > pages * page_keys)
+    {
+      reserve_pages(std::max((size + other.size + page_keys - 1) / page_keys, 2 * pages));
+    }
+    for (std::size_t k = 0; k < other.size; ++k)
+    {
+      KeyTraits::construct(alloc, slots + slot_of(size + k), std::move(other.slots[slot_of(k)]));
+    }
+    size += other.size;
+    other.clear();
+
+    heapify();
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys in the order they are stored in the array, i.e. page by
+   * page, and in level order within every page.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  void print() const
+  {
+    if (size == 0)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      std::cout << slots[slot_of(k)] << ", ";
+    }
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n log n), where n is the number of keys in
+   * the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(BHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(alloc);
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The keys are appended to the array, which is then heapified bottom-up.
+   *
+   * The time complexity of this operation is O(n + k), where n is the number of keys in
+   * the heap and k is the number of keys in the batch.
+   *
+   * @param batch The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> batch)
+  {
+    reserve(size + batch.size());
+    for (T &key : batch)
+    {
+      KeyTraits::construct(alloc, slots + slot_of(size), std::move(key));
+      ++size;
+    }
+    heapify();
+  }
+
+private:
+  [[no_unique_address]] KeyAllocator alloc; ///< The allocator of the array.
+  T *allocation;                            ///< The allocated array, including the alignment slack.
+  T *slots;                                 ///< The first slot of the first page.
+  std::size_t size;                         ///< The number of keys in the heap.
+  std::size_t pages;                        ///< The number of pages the array can hold.
+
+  /**
+   * @brief Returns the number of slots to allocate for the given number of pages, including
+   * one page of slack for aligning the first page.
+   */
+  static constexpr std::size_t allocation_size(std::size_t page_count) noexcept
+  {
+    return (page_count + 1) * page_slots;
+  }
+
+  /**
+   * @brief Returns the slot of the k-th key, counting the keys page by page.
+   */
+  static constexpr std::size_t slot_of(std::size_t k) noexcept
+  {
+    return k / page_keys * page_slots + k % page_keys + 1;
+  }
+
+  /**
+   * @brief Reallocates the array to hold the given number of pages.
+   *
+   * Since the slot of every key does not depend on the number of pages, the keys are
+   * moved to the same slots of the new array.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap, or O(1) if the array already holds enough pages.
+   *
+   * @param new_pages The number of pages the array should hold.
+   */
+  constexpr void reserve_pages(std::size_t new_pages)
+  {
+    if (new_pages <= pages)
+    {
+      return;
+    }
+
+    T *new_allocation = KeyTraits::allocate(alloc, allocation_size(new_pages));
+    T *new_slots = new_allocation;
+    if !consteval
+    {
+      const std::size_t misalignment = reinterpret_cast<std::uintptr_t>(new_allocation) % PageSize;
+      if (misalignment != 0 && (PageSize - misalignment) % sizeof(T) == 0)
+      {
+        new_slots += (PageSize - misalignment) / sizeof(T);
+      }
+    }
+
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      const std::size_t slot = slot_of(k);
+      KeyTraits::construct(alloc, new_slots + slot, std::move(slots[slot]));
+      KeyTraits::destroy(alloc, slots + slot);
+    }
+    if (allocation != nullptr)
+    {
+      KeyTraits::deallocate(alloc, allocation, allocation_size(pages));
+    }
+
+    allocation = new_allocation;
+    slots = new_slots;
+    pages = new_pages;
+  }
+
+  /**
+   * @brief Returns the slot of the parent of the key at the given slot.
+   *
+   * @pre The slot is not the root of the heap.
+   */
+  static constexpr std::size_t parent_of(std::size_t slot) noexcept
+  {
+    const std::size_t page = slot / page_slots;
+    const std::size_t local = slot % page_slots;
+    if (local > 1)
+    {
+      return page * page_slots + local / 2;
+    }
+
+    // the root of a page hangs from a leaf of its parent page
+    const std::size_t order = page - 1;
+    return order / page_slots * page_slots + first_leaf + order % page_slots / 2;
+  }
+
+  /**
+   * @brief Returns the slot of the first child of the key at the given slot. The second
+   * child is at the returned slot plus `stride`, where `stride` is set to 1 if the children
+   * are in the same page, and to the number of slots in a page otherwise.
+   */
+  static constexpr std::size_t first_child_of(std::size_t slot, std::size_t &stride) noexcept
+  {
+    const std::size_t page = slot / page_slots;
+    const std::size_t local = slot % page_slots;
+    if (local < first_leaf)
+    {
+      stride = 1;
+      return page * page_slots + 2 * local;
+    }
+
+    // the children of a leaf are the roots of two child pages
+    stride = page_slots;
+    const std::size_t child_page = page * page_slots + 2 * (local - first_leaf) + 1;
+    return child_page * page_slots + 1;
+  }
+
+  /**
+   * @brief Moves the key at the given slot up to its place.
+   *
+   * The time complexity of this operation is O(log n).
+   *
+   * @param slot The slot of the key to sift up.
+   */
+  constexpr void sift_up(std::size_t slot)
+  {
+    T key = std::move(slots[slot]);
+    while (slot != 1)
+    {
+      const std::size_t parent = parent_of(slot);
+      if (!(key < slots[parent]))
+      {
+        break;
+      }
+      slots[slot] = std::move(slots[parent]);
+      slot = parent;
+    }
+    slots[slot] = std::move(key);
+  }
+
+  /**
+   * @brief Moves a key down from the given slot to its place.
+   *
+   * The key at `slot` is treated as a hole; at every step the smaller child is moved into
+   * the hole, until `key` is not greater than it. A child exists if its slot comes before
+   * the slot of the next key to be inserted, since the slots of the keys increase with
+   * their order.
+   *
+   * The time complexity of this operation is O(log n).
+   *
+   * @param slot The slot of the hole to start from.
+   * @param key The key to place.
+   */
+  constexpr void sift_down(std::size_t slot, T key)
+  {
+    const std::size_t end = slot_of(size);
+    while (true)
+    {
+      std::size_t stride = 0;
+      std::size_t min = first_child_of(slot, stride);
+      if (min >= end)
+      {
+        break;
+      }
+      if (const std::size_t second = min + stride; second < end && slots[second] < slots[min])
+      {
+        min = second;
+      }
+      if (!(slots[min] < key))
+      {
+        break;
+      }
+      slots[slot] = std::move(slots[min]);
+      slot = min;
+    }
+    slots[slot] = std::move(key);
+  }
+
+  /**
+   * @brief Restores the heap property of the whole array, bottom-up.
+   *
+   * The keys are sifted down in reverse order, so the children of every key, which come
+   * after it, are heaps by the time it is sifted down.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr void heapify()
+  {
+    for (std::size_t k = size; k-- > 0;)
+    {
+      const std::size_t slot = slot_of(k);
+      T key = std::move(slots[slot]);
+      sift_down(slot, std::move(key));
+    }
+  }
+}; // class BHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `BHeap` that allocates its array from a `std::pmr::memory_resource`.
+   */
+  template <typename T, std::size_t PageSize = 4096>
+  using BHeap = ::BHeap<T, PageSize, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // B_HEAP_H
@@ -0,0 +1,90 @@
+#ifndef BINOMIAL_TREE_H
+#define BINOMIAL_TREE_H
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief The binomial trees shared by `LazyBinomialHeap` and `EagerBinomialHeap`.
+ *
+ * @details Both heaps are collections of binomial trees, linked by the same operation;
+ * they only differ in how, and when, trees of the same degree are linked. `EagerBinomialHeap`
+ * uses `binomial::Node`, while `LazyBinomialHeap` uses a node that also links to its parent,
+ * so that it can cut nodes from their trees. `link` works with either; root_list.h adds the
+ * parent and backward links on top of it. Both heaps destroy their trees with
+ * `forest::destroy`.
+ */
+namespace binomial
+{
+  /**
+   * @struct Node
+   * @brief A node in a binomial tree.
+   *
+   * Each node contains a key of type `T`, a degree representing the number of children,
+   * and pointers to its sibling and child nodes.
+   *
+   * @note The linked-list is implemented using the left-child, right-sibling (LCRS) idiom.
+   * The children of a node form a null-terminated singly linked list in descending order
+   * of degree. How the roots are linked is up to the heap.
+   *
+   * @tparam T The type of the key stored in the node. `T` must be movable, as it is moved
+   * into the node in the constructor.
+   */
+  template <typename T>
+  struct Node
+  {
+    T key;         ///< The key stored in the node.
+    int degree;    ///< The degree of the binomial tree represented by this node.
+    Node *sibling; ///< A pointer to the node's next sibling.
+    Node *child;   ///< A pointer to the node's first child.
+
+    /**
+     * @brief Constructs a new node whose key is constructed in place from the given arguments.
+     *
+     * This constructor initializes a binomial tree of degree 0.
+     *
+     * @param args The arguments forwarded to the constructor of the key.
+     */
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) : key(std::forward<Args>(args)...), degree(0), sibling(nullptr), child(nullptr) {}
+
+    /**
+     * @brief Default destructor.
+     *
+     * The deletion of the sibling and child nodes is handled by the heap.
+     */
+    constexpr ~Node() = default;
+  };
+
+  /**
+   * @brief Links two trees of the same degree.
+   *
+   * The tree with the larger key becomes the first child of the tree with the smaller
+   * key, resulting in a binomial tree of a higher degree. On equal keys, `tree1` stays the
+   * root. The sibling pointer of the resulting root is left untouched.
+   *
+   * The time complexity of this operation is O(1), because it only involves updating the
+   * sibling and child pointers of the trees.
+   *
+   * @param tree1 The first tree to link.
+   * @param tree2 The second tree to link.
+   * @param less The order of the keys of the heap.
+   * @return The resulting tree after the link.
+   */
+  template <typename TreeNode, typename Less = std::less<>>
+  constexpr TreeNode *link(TreeNode *tree1, TreeNode *tree2, const Less &less = Less())
+  {
+    if (less(tree2->key, tree1->key))
+    {
+      std::swap(tree1, tree2);
+    }
+    tree2->sibling = tree1->child;
+    tree1->child = tree2;
+    tree1->degree += 1;
+
+    return tree1;
+  }
+} // namespace binomial
+
+#endif // BINOMIAL_TREE_H
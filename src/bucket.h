@@ -0,0 +1,371 @@
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include "mergeable_heap.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class BucketQueue
+ *
+ * @brief A mergeable heap for integer keys from a small, bounded range.
+ *
+ * @details The heap keeps one bucket per possible key in [0, Range). Since equal integer
+ * keys are indistinguishable, a bucket only counts the copies of its key, so any number of
+ * duplicates takes no extra memory. The non-empty buckets are tracked by a two-level
+ * bitmap: one bit per bucket, and one summary bit per 64-bit word of the bitmap. The next
+ * non-empty bucket is therefore found with two `std::countr_zero` instructions, and
+ * insert and extract_min take O(1) time, regardless of the number of keys in the heap.
+ *
+ * @tparam T The type of the keys stored in the heap, an integer type.
+ * @tparam Range The number of possible keys; keys must lie in [0, Range).
+ * @tparam Allocator The allocator used to allocate the buckets and the bitmaps.
+ */
+template <std::integral T, std::size_t Range = 4096, typename Allocator = std::allocator<T>>
+class BucketQueue final : public MergeableHeapBase<BucketQueue<T, Range, Allocator>, T>
+{
+  using Base = MergeableHeapBase<BucketQueue, T>; ///< The non-virtual base of the heap.
+
+  static_assert(Range > 0, "A bucket queue needs at least one bucket");
+
+private:
+  using Count = std::size_t;
+  using Word = std::uint64_t;
+
+  template <typename U>
+  using Vector = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+
+  static constexpr std::size_t word_bits = 64;
+  static constexpr std::size_t word_count = (Range + word_bits - 1) / word_bits;
+  static constexpr std::size_t summary_count = (word_count + word_bits - 1) / word_bits;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(Range).
+   */
+  constexpr BucketQueue() : BucketQueue(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its buckets using the given allocator.
+   *
+   * The time complexity of this operation is O(Range).
+   *
+   * @param alloc The allocator used to allocate the buckets and the bitmaps.
+   */
+  constexpr explicit BucketQueue(const Allocator &alloc) : counts(Range, alloc), words(word_count, alloc), summary(summary_count, alloc), min(0), size(0) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(Range + k), where k is the number of keys
+   * in the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the buckets and the bitmaps.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr BucketQueue(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : BucketQueue(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(Range + k), where k is the number of keys
+   * in the range.
+   */
+  template <std::ranges::input_range Range_>
+  static constexpr BucketQueue from_range(Range_ &&range, const Allocator &alloc = Allocator())
+  {
+    return BucketQueue(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr ~BucketQueue() = default;
+
+  /**
+   * @brief Constructs a key from the given arguments, and inserts it into the heap.
+   *
+   * The keys are integers, which are not stored in nodes, so the key is simply constructed
+   * and inserted.
+   *
+   * @param args The arguments forwarded to the constructor of the key.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    insert(T(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The count of the key's bucket is incremented, and the bucket is marked as non-empty.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param key The key to insert.
+   * @throws std::out_of_range If the key does not lie in [0, Range).
+   */
+  constexpr void insert(T key)
+  {
+    if (key < 0 || static_cast<std::make_unsigned_t<T>>(key) >= Range)
+    {
+      throw std::out_of_range("A bucket queue only holds keys in [0, " + std::to_string(Range) + ")");
+    }
+
+    const std::size_t bucket = static_cast<std::size_t>(key);
+    if (counts[bucket]++ == 0)
+    {
+      mark(bucket);
+    }
+    min = size == 0 ? key : std::min(min, key);
+    ++size;
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The time complexity of this operation is O(Range / 64 + d), where d is the number of
+   * distinct keys in the heap.
+   */
+  constexpr void clear() noexcept
+  {
+    for_each_bucket([this](std::size_t bucket)
+                    { counts[bucket] = 0; });
+    std::ranges::fill(words, Word{0});
+    std::ranges::fill(summary, Word{0});
+    min = 0;
+    size = 0;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is cached.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+    return std::cref(min);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The count of the minimum bucket is decremented. If the bucket runs empty, it is
+   * unmarked, and the next non-empty bucket is found using the bitmaps.
+   *
+   * The time complexity of this operation is O(Range / 4096), i.e. O(1) for up to 4096
+   * possible keys.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+
+    const T key = min;
+    const std::size_t bucket = static_cast<std::size_t>(key);
+    --size;
+    if (--counts[bucket] == 0)
+    {
+      unmark(bucket);
+      if (size > 0)
+      {
+        min = static_cast<T>(first());
+      }
+    }
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The counts of the non-empty buckets of the other heap are added to this heap, visiting
+   * only the set bits of its bitmap.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * The time complexity of this operation is O(Range / 64 + d), where d is the number of
+   * distinct keys in the other heap.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(BucketQueue &other)
+  {
+    if (other.size == 0)
+    {
+      return;
+    }
+
+    other.for_each_bucket([&](std::size_t bucket)
+                               {
+                                 if (counts[bucket] == 0)
+                                 {
+                                   mark(bucket);
+                                 }
+                                 counts[bucket] += std::exchange(other.counts[bucket], 0); });
+    min = size == 0 ? other.min : std::min(min, other.min);
+    size += other.size;
+
+    other.clear();
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the distinct keys in ascending order, each followed by its number
+   * of copies if it appears more than once.
+   *
+   * The time complexity of this operation is O(Range / 64 + d), where d is the number of
+   * distinct keys in the heap.
+   */
+  void print() const
+  {
+    if (size == 0)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for_each_bucket([this](std::size_t bucket)
+                    {
+                      std::cout << bucket;
+                      if (counts[bucket] > 1)
+                      {
+                        std::cout << " (x" << counts[bucket] << ")";
+                      }
+                      std::cout << ", "; });
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(Range + n), where n is the number of keys
+   * in the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(BucketQueue(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(counts.get_allocator());
+  }
+
+private:
+  Vector<Count> counts; ///< The number of copies of every key.
+  Vector<Word> words;   ///< Bit b of word w is set if bucket 64w + b is not empty.
+  Vector<Word> summary; ///< Bit b of word s is set if word 64s + b of `words` is not zero.
+  T min;                ///< The minimum key, if the heap is not empty.
+  std::size_t size;     ///< The number of keys in the heap.
+
+  /**
+   * @brief Marks a bucket as non-empty.
+   */
+  constexpr void mark(std::size_t bucket) noexcept
+  {
+    const std::size_t word = bucket / word_bits;
+    words[word] |= Word{1} << (bucket % word_bits);
+    summary[word / word_bits] |= Word{1} << (word % word_bits);
+  }
+
+  /**
+   * @brief Marks a bucket as empty.
+   */
+  constexpr void unmark(std::size_t bucket) noexcept
+  {
+    const std::size_t word = bucket / word_bits;
+    words[word] &= ~(Word{1} << (bucket % word_bits));
+    if (words[word] == 0)
+    {
+      summary[word / word_bits] &= ~(Word{1} << (word % word_bits));
+    }
+  }
+
+  /**
+   * @brief Returns the first non-empty bucket.
+   *
+   * The time complexity of this operation is O(Range / 4096).
+   *
+   * @pre The heap is not empty.
+   */
+  constexpr std::size_t first() const noexcept
+  {
+    std::size_t s = 0;
+    while (summary[s] == 0)
+    {
+      ++s;
+    }
+    const std::size_t word = s * word_bits + static_cast<std::size_t>(std::countr_zero(summary[s]));
+    return word * word_bits + static_cast<std::size_t>(std::countr_zero(words[word]));
+  }
+
+  /**
+   * @brief Calls a function for every non-empty bucket, in ascending order.
+   *
+   * The time complexity of this operation is O(Range / 64 + d), where d is the number of
+   * non-empty buckets.
+   */
+  template <typename F>
+  constexpr void for_each_bucket(F &&f) const
+  {
+    for (std::size_t word = 0; word < word_count; ++word)
+    {
+      for (Word bits = words[word]; bits != 0; bits &= bits - 1)
+      {
+        f(word * word_bits + static_cast<std::size_t>(std::countr_zero(bits)));
+      }
+    }
+  }
+}; // class BucketQueue
+
+namespace pmr
+{
+  /**
+   * @brief A `BucketQueue` that allocates its buckets from a `std::pmr::memory_resource`.
+   */
+  template <std::integral T, std::size_t Range = 4096>
+  using BucketQueue = ::BucketQueue<T, Range, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,489 @@
+#ifndef CHUNKED_HEAP_H
+#define CHUNKED_HEAP_H
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+#include "mergeable_heap.h"
+#include "simd.h"
+
+/**
+ * @class ChunkedUnsortedHeap
+ *
+ * @brief A mergeable heap data structure implementation using an unrolled linked list.
+ *
+ * @details This mergeable heap is a variant of `UnsortedLinkedHeap` in which every node of
+ * the linked list, called a chunk, holds up to `ChunkSize` unsorted keys in a contiguous
+ * array, along with the index of the minimum key within the chunk. The heap keeps a pointer
+ * to the chunk holding the minimum key of the whole heap.
+ *
+ * Extracting the minimum only rescans the chunk it was removed from, plus the cached minima
+ * of all chunks, so it takes O(n/B + B) time instead of chasing n pointers, where B is the
+ * chunk size. Both scans walk contiguous memory. To keep the chunks dense, any two
+ * adjacent chunks together hold more than B keys, so a heap of n keys has at most
+ * 2n/B + 1 chunks. A chunk that loses a key absorbs its successor, or is absorbed by its
+ * predecessor, whenever their keys fit in a single chunk, and merging two heaps joins the
+ * two chunks at the seam the same way.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be default constructible
+ * and movable, as the keys are moved into preallocated arrays.
+ * @tparam ChunkSize The maximum number of keys stored in a single chunk.
+ * @tparam Allocator The allocator used to allocate the chunks of the heap.
+ */
+template <typename T, std::size_t ChunkSize = 64, typename Allocator = std::allocator<T>>
+class ChunkedUnsortedHeap final : public MergeableHeapBase<ChunkedUnsortedHeap<T, ChunkSize, Allocator>, T>
+{
+  using Base = MergeableHeapBase<ChunkedUnsortedHeap, T>; ///< The non-virtual base of the heap.
+
+  static_assert(ChunkSize > 0, "A chunk must be able to hold at least one key");
+
+private:
+  struct Chunk
+  {
+    std::array<T, ChunkSize> keys; ///< The keys stored in the chunk, in no particular order.
+    std::size_t count;             ///< The number of keys stored in the chunk.
+    std::size_t min;               ///< The index of the minimum key in the chunk.
+    Chunk *next;                   ///< A pointer to the next chunk in the linked list.
+    Chunk *prev;                   ///< A pointer to the previous chunk in the linked list.
+
+    /**
+     * @brief Constructs a new empty chunk.
+     */
+    constexpr Chunk() : keys(), count(0), min(0), next(nullptr), prev(nullptr) {}
+
+    /**
+     * @brief Updates the index of the minimum key in the chunk.
+     *
+     * The keys are contiguous, so the search uses `simd::argmin`, which runs a vector
+     * kernel for arithmetic keys.
+     *
+     * The time complexity of this operation is O(B), where B is the chunk size.
+     *
+     * @pre The chunk is not empty.
+     */
+    constexpr void update_min() noexcept
+    {
+      min = simd::argmin(keys.data(), count);
+    }
+  };
+
+  using ChunkAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+  using ChunkTraits = std::allocator_traits<ChunkAllocator>;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr ChunkedUnsortedHeap() : ChunkedUnsortedHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its chunks using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the chunks of the heap.
+   */
+  constexpr explicit ChunkedUnsortedHeap(const Allocator &alloc) : alloc(alloc), head(nullptr), tail(nullptr), min(nullptr) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the chunks of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr ChunkedUnsortedHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : ChunkedUnsortedHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr ChunkedUnsortedHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return ChunkedUnsortedHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The destructor deletes all chunks in the linked list.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr ~ChunkedUnsortedHeap()
+  {
+    for (Chunk *current = head; current != nullptr;)
+    {
+      Chunk *next = current->next;
+      destroy_chunk(current);
+      current = next;
+    }
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The key is appended to the last chunk, or to a new chunk if the last one is full. The
+   * minimum of the chunk and of the heap are updated if the new key is smaller.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param args The arguments forwarded to the constructor of the key. The slots of a chunk
+   * always hold constructed keys, so the new key is move-assigned to its slot.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    if (tail == nullptr || tail->count == ChunkSize)
+    {
+      Chunk *chunk = create_chunk();
+      if (head == nullptr)
+      {
+        head = tail = chunk;
+      }
+      else
+      {
+        tail->next = chunk;
+        chunk->prev = tail;
+        tail = chunk;
+      }
+    }
+
+    const std::size_t index = tail->count++;
+    tail->keys[index] = T(std::forward<Args>(args)...);
+    if (tail->keys[index] < tail->keys[tail->min])
+    {
+      tail->min = index;
+    }
+    if (min == nullptr || tail->keys[tail->min] < min->keys[min->min])
+    {
+      min = tail;
+    }
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the chunk holding the minimum
+   * key and its index within the chunk are always available.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const
+  {
+    if (min == nullptr)
+    {
+      return std::nullopt;
+    }
+    return std::cref(min->keys[min->min]);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The minimum key is replaced by the last key of its chunk. If the chunk and its
+   * successor then fit in a single chunk, the successor is absorbed; likewise, if the chunk
+   * then fits into its predecessor, it is absorbed by the predecessor, so no two adjacent
+   * chunks hold B keys or fewer together. Finally, the minimum of the remaining chunk is
+   * recomputed, and the new minimum chunk is found by scanning the cached minima of all
+   * chunks.
+   *
+   * The time complexity of this operation is O(n/B + B), where n is the number of keys in
+   * the heap and B is the chunk size.
+   *
+   * @return The minimum key in the heap, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (min == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    Chunk *chunk = min;
+    T key = std::move(chunk->keys[chunk->min]);
+    if (--chunk->count != chunk->min)
+    {
+      chunk->keys[chunk->min] = std::move(chunk->keys[chunk->count]);
+    }
+
+    if (Chunk *next = chunk->next; next != nullptr && chunk->count + next->count <= ChunkSize)
+    {
+      absorb(chunk, next);
+    }
+    if (Chunk *prev = chunk->prev; prev != nullptr && prev->count + chunk->count <= ChunkSize)
+    {
+      absorb(prev, chunk);
+      chunk = prev;
+    }
+
+    if (chunk->count == 0) // the only chunk in the heap
+    {
+      unlink(chunk);
+      destroy_chunk(chunk);
+    }
+    else
+    {
+      chunk->update_min(); // O(B)
+    }
+
+    update_min(); // O(n/B)
+
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The chunk list of the other heap is concatenated to the end of the chunk list of this
+   * heap, and the minimum is updated if the other heap contains a smaller key. If the last
+   * chunk of this heap and the first chunk of the other heap fit in a single chunk, they
+   * are joined, so the chunks stay dense.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the chunks of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
+   * The time complexity of this operation is O(B), where B is the chunk size.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(ChunkedUnsortedHeap &other)
+  {
+    if (other.head == nullptr)
+    {
+      return;
+    }
+
+    if (head == nullptr)
+    {
+      head = other.head;
+      tail = other.tail;
+      min = other.min;
+    }
+    else
+    {
+      Chunk *seam = tail;
+      tail->next = other.head;
+      other.head->prev = tail;
+      tail = other.tail;
+
+      if (other.min->keys[other.min->min] < min->keys[min->min])
+      {
+        min = other.min;
+      }
+
+      if (Chunk *next = seam->next; seam->count + next->count <= ChunkSize)
+      {
+        if (min == next)
+        {
+          min = seam;
+        }
+        absorb(seam, next);
+        seam->update_min(); // O(B)
+      }
+    }
+
+    other.head = other.tail = other.min = nullptr;
+  }
+
+  /**
+   * @brief Returns the number of chunks in the heap.
+   *
+   * The time complexity of this operation is O(n/B), where n is the number of keys in the
+   * heap and B is the chunk size.
+   */
+  constexpr std::size_t chunks() const noexcept
+  {
+    std::size_t count = 0;
+    for (Chunk *current = head; current != nullptr; current = current->next)
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This function prints the keys in the heap chunk by chunk. The keys are separated by
+   * commas and followed by a period.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  void print() const
+  {
+    if (head == nullptr)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for (Chunk *current = head; current != nullptr; current = current->next)
+    {
+      for (std::size_t i = 0; i < current->count; ++i)
+      {
+        std::cout << current->keys[i] << ", ";
+      }
+    }
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n^2 / B + n B), where n is the number of
+   * keys in the heap and B is the chunk size.
+   */
+  void sort()
+  {
+    this->Base::sort(ChunkedUnsortedHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(alloc);
+  }
+
+private:
+  [[no_unique_address]] ChunkAllocator alloc; ///< The allocator used to allocate the chunks.
+  Chunk *head;                                ///< A pointer to the first chunk in the linked list.
+  Chunk *tail;                                ///< A pointer to the last chunk in the linked list.
+  Chunk *min;                                 ///< A pointer to the chunk with the minimum key.
+
+  /**
+   * @brief Allocates and constructs a new empty chunk.
+   */
+  constexpr Chunk *create_chunk()
+  {
+    Chunk *chunk = ChunkTraits::allocate(alloc, 1);
+    ChunkTraits::construct(alloc, chunk);
+    return chunk;
+  }
+
+  /**
+   * @brief Destroys and deallocates a chunk.
+   */
+  constexpr void destroy_chunk(Chunk *chunk) noexcept
+  {
+    ChunkTraits::destroy(alloc, chunk);
+    ChunkTraits::deallocate(alloc, chunk, 1);
+  }
+
+  /**
+   * @brief Unlinks a chunk from the linked list, without destroying it.
+   */
+  constexpr void unlink(Chunk *chunk) noexcept
+  {
+    if (chunk->prev != nullptr)
+    {
+      chunk->prev->next = chunk->next;
+    }
+    else
+    {
+      head = chunk->next;
+    }
+    if (chunk->next != nullptr)
+    {
+      chunk->next->prev = chunk->prev;
+    }
+    else
+    {
+      tail = chunk->prev;
+    }
+  }
+
+  /**
+   * @brief Moves the keys of a chunk to the end of its predecessor, and destroys it.
+   *
+   * The minimum index of `into` is left for the caller to update.
+   *
+   * The time complexity of this operation is O(B), where B is the chunk size.
+   *
+   * @param into The chunk the keys are moved to.
+   * @param from The chunk right after `into`. Its keys must fit into `into`.
+   */
+  constexpr void absorb(Chunk *into, Chunk *from) noexcept(std::is_nothrow_move_assignable_v<T>)
+  {
+    for (std::size_t i = 0; i < from->count; ++i)
+    {
+      into->keys[into->count++] = std::move(from->keys[i]);
+    }
+    unlink(from);
+    destroy_chunk(from);
+  }
+
+  /**
+   * @brief Updates the minimum chunk pointer by scanning the cached minima of all chunks.
+   *
+   * The time complexity of this operation is O(n/B), where n is the number of keys in the
+   * heap and B is the chunk size.
+   */
+  constexpr void update_min() noexcept
+  {
+    min = head;
+    if (head == nullptr)
+    {
+      return;
+    }
+    for (Chunk *current = head->next; current != nullptr; current = current->next)
+    {
+      if (current->keys[current->min] < min->keys[min->min])
+      {
+        min = current;
+      }
+    }
+  }
+}; // class ChunkedUnsortedHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `ChunkedUnsortedHeap` that allocates its chunks from a `std::pmr::memory_resource`.
+   */
+  template <typename T, std::size_t ChunkSize = 64>
+  using ChunkedUnsortedHeap = ::ChunkedUnsortedHeap<T, ChunkSize, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // CHUNKED_HEAP_H
@@ -0,0 +1,401 @@
+#ifndef COMPACT_HEAP_H
+#define COMPACT_HEAP_H
+
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+#include "mergeable_heap.h"
+
+/**
+ * @class CompactUnsortedHeap
+ *
+ * @brief An `UnsortedLinkedHeap` whose nodes are stored contiguously and linked by index.
+ *
+ * @details This mergeable heap is implemented using an unsorted doubly linked list, just
+ * like `UnsortedLinkedHeap`, except that all nodes live in a single `std::vector` and link
+ * to each other using 32-bit indices instead of pointers. For small keys this roughly
+ * halves the memory used per element, and since new nodes are appended to the vector, the
+ * linear scan for the new minimum walks mostly sequential memory. The slots of extracted
+ * nodes are kept in a free list, which is threaded through their `next` indices, and are
+ * reused by later insertions.
+ *
+ * @note The heap holds at most 2^32 - 1 slots; inserting beyond that throws
+ * `std::length_error`.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method, and move-assignable, as free slots are reused.
+ * @tparam Allocator The allocator used to allocate the node vector.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class CompactUnsortedHeap final : public MergeableHeapBase<CompactUnsortedHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<CompactUnsortedHeap, T>; ///< The non-virtual base of the heap.
+
+private:
+  using Index = std::uint32_t;
+
+  static constexpr Index npos = static_cast<Index>(-1); ///< The null index.
+
+  struct Node
+  {
+    T key;      ///< The key stored in the node.
+    Index next; ///< The index of the next node in the linked list, or of the next free slot.
+    Index prev; ///< The index of the previous node in the linked list.
+
+    /**
+     * @brief Constructs a new unlinked node whose key is constructed in place from the given arguments.
+     *
+     * @param args The arguments forwarded to the constructor of the key.
+     */
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) : key(std::forward<Args>(args)...), next(npos), prev(npos) {}
+  };
+
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr CompactUnsortedHeap() : CompactUnsortedHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the node vector.
+   */
+  constexpr explicit CompactUnsortedHeap(const Allocator &alloc) : nodes(NodeAllocator(alloc)), head(npos), tail(npos), min(npos), free(npos) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr CompactUnsortedHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : CompactUnsortedHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr CompactUnsortedHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return CompactUnsortedHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(n), where n is the number of slots in the
+   * node vector.
+   */
+  constexpr ~CompactUnsortedHeap() = default;
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The key is stored in a free slot if one is available, or appended to the node vector
+   * otherwise. The node is linked at the end of the list, and the minimum is updated if
+   * the new key is smaller than the current minimum.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node, or assigned to the key of a free slot.
+   * @throws std::length_error If no slot is free and the heap already holds 2^32 - 1 slots.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    Index index = free;
+    if (index != npos)
+    {
+      free = nodes[index].next;
+      nodes[index].key = T(std::forward<Args>(args)...);
+      nodes[index].next = npos;
+    }
+    else
+    {
+      index = next_index();
+      nodes.emplace_back(std::in_place, std::forward<Args>(args)...);
+    }
+
+    Node &node = nodes[index];
+    node.prev = tail;
+    if (head == npos)
+    {
+      head = index;
+    }
+    else
+    {
+      nodes[tail].next = index;
+    }
+    tail = index;
+
+    if (min == npos || node.key < nodes[min].key)
+    {
+      min = index;
+    }
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the index of the minimum node
+   * is always kept up to date.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const
+  {
+    if (min == npos)
+    {
+      return std::nullopt;
+    }
+    return std::cref(nodes[min].key);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The minimum node is unlinked from the list and its slot is pushed onto the free list.
+   * Then the list is scanned for the new minimum.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, because the new minimum key must be searched for in the entire linked list.
+   *
+   * @return The minimum key in the heap, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (min == npos)
+    {
+      return std::nullopt;
+    }
+
+    Node &node = nodes[min];
+    T key = std::move(node.key);
+
+    if (node.prev != npos) // min is not the head
+    {
+      nodes[node.prev].next = node.next;
+    }
+    else
+    {
+      head = node.next;
+    }
+    if (node.next != npos) // min is not the tail
+    {
+      nodes[node.next].prev = node.prev;
+    }
+    else
+    {
+      tail = node.prev;
+    }
+
+    node.next = free;
+    free = min;
+
+    update_min(); // O(n)
+
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * If this heap holds no slots, the node vectors are simply swapped. Otherwise the live
+   * nodes of the other heap are moved to the end of this heap's node vector, and are
+   * linked after the tail of this heap.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the node vectors may be swapped.
+   *
+   * The time complexity of this operation is O(1) if this heap holds no slots, and O(m)
+   * otherwise, where m is the number of nodes in the other heap.
+   *
+   * @param other The heap to merge into this heap.
+   * @throws std::length_error If the merged heap would hold more than 2^32 - 1 slots.
+   */
+  constexpr void merge(CompactUnsortedHeap &other)
+  {
+    if (other.head == npos)
+    {
+      return;
+    }
+
+    if (nodes.empty())
+    {
+      std::swap(nodes, other.nodes);
+      head = other.head;
+      tail = other.tail;
+      min = other.min;
+      free = other.free;
+    }
+    else
+    {
+      for (Index current = other.head; current != npos; current = other.nodes[current].next)
+      {
+        Index index = next_index();
+        nodes.emplace_back(std::in_place, std::move(other.nodes[current].key));
+        nodes[index].prev = tail;
+        if (head == npos)
+        {
+          head = index;
+        }
+        else
+        {
+          nodes[tail].next = index;
+        }
+        tail = index;
+        if (current == other.min && (min == npos || nodes[index].key < nodes[min].key))
+        {
+          min = index;
+        }
+      }
+      other.nodes.clear();
+    }
+
+    other.head = other.tail = other.min = other.free = npos;
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This function prints the keys in the heap in the order they are stored in the linked
+   * list. The keys are separated by commas and followed by a period.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap.
+   */
+  void print() const
+  {
+    if (head == npos)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for (Index current = head; current != npos; current = nodes[current].next)
+    {
+      std::cout << nodes[current].key << ", ";
+    }
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n^2), where n is the number of nodes in the
+   * heap, because the minimum key must be extracted n times, and each extraction takes
+   * O(n) time.
+   */
+  void sort()
+  {
+    this->Base::sort(CompactUnsortedHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(nodes.get_allocator());
+  }
+
+private:
+  std::vector<Node, NodeAllocator> nodes; ///< The slots of the nodes, live or free.
+  Index head;                             ///< The index of the first node in the linked list.
+  Index tail;                             ///< The index of the last node in the linked list.
+  Index min;                              ///< The index of the node with the minimum key.
+  Index free;                             ///< The index of the first free slot.
+
+  /**
+   * @brief Returns the index of the next slot appended to the node vector.
+   *
+   * The indices are 32 bits wide, and `npos` is reserved for the null index, so the number
+   * of slots is checked before it is narrowed.
+   *
+   * @throws std::length_error If the heap already holds 2^32 - 1 slots.
+   */
+  constexpr Index next_index() const
+  {
+    if (nodes.size() >= npos)
+    {
+      throw std::length_error("A compact unsorted heap holds at most 2^32 - 1 keys");
+    }
+    return static_cast<Index>(nodes.size());
+  }
+
+  /**
+   * @brief Updates the index of the minimum node by scanning the linked list.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap.
+   */
+  constexpr void update_min() noexcept
+  {
+    min = head;
+    if (head == npos)
+    {
+      return;
+    }
+    for (Index current = nodes[head].next; current != npos; current = nodes[current].next)
+    {
+      if (nodes[current].key < nodes[min].key)
+      {
+        min = current;
+      }
+    }
+  }
+}; // class CompactUnsortedHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `CompactUnsortedHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T>
+  using CompactUnsortedHeap = ::CompactUnsortedHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // COMPACT_HEAP_H
@@ -0,0 +1,480 @@
+#ifndef ARRAY_DARY_HEAP_H
+#define ARRAY_DARY_HEAP_H
+
+#include "mergeable_heap.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class ArrayDaryHeap
+ *
+ * @brief An implicit d-ary heap stored in a single contiguous array.
+ *
+ * @details The keys are stored in level order in one array, so the heap does not allocate
+ * any node and does not chase any pointer: the children of the key at index i are the
+ * keys at indices D*i + 1 through D*i + D, and its parent is the key at index (i - 1) / D.
+ * Compared to a binary heap, a larger D halves or quarters the height of the tree, at the
+ * cost of comparing D children in each step of a sift-down.
+ *
+ * The array is aligned to a 64-byte cache line where possible, like the pages of `BHeap`,
+ * and preceded by D - 1 unused slots, so that the children of every key start at a
+ * multiple of D slots from the aligned start. As long as D * sizeof(T) divides 64 (e.g.
+ * D = 4 and 32-bit keys), the children of a key never straddle a cache line, and each
+ * step of a sift-down touches a single cache line.
+ *
+ * Insertions and extractions move a "hole" along the path instead of swapping keys, so
+ * every step performs a single move.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method, and move-assignable, as it is moved along the
+ * heap in the sift operations.
+ * @tparam D The number of children of every node. `D` must be at least 2.
+ * @tparam Allocator The allocator used to allocate the array.
+ */
+template <typename T, std::size_t D = 4, typename Allocator = std::allocator<T>>
+class ArrayDaryHeap final : public MergeableHeapBase<ArrayDaryHeap<T, D, Allocator>, T>
+{
+  using Base = MergeableHeapBase<ArrayDaryHeap, T>; ///< The non-virtual base of the heap.
+  friend Base;
+
+  static_assert(D >= 2, "A d-ary heap needs at least two children per node");
+
+private:
+  using KeyAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using KeyTraits = std::allocator_traits<KeyAllocator>;
+
+  static constexpr std::size_t padding = D - 1;                ///< The number of unused slots before the root.
+  static constexpr std::size_t min_capacity = 4 * D;           ///< The capacity of the first allocation.
+  static constexpr std::size_t cache_line = 64;                ///< The size of a cache line in bytes.
+  static constexpr std::size_t slack = cache_line / sizeof(T); ///< The slots allocated for aligning the array.
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * No memory is allocated until the first key is inserted.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr ArrayDaryHeap() : ArrayDaryHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its array using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the array.
+   */
+  constexpr explicit ArrayDaryHeap(const Allocator &alloc) noexcept : alloc(alloc), allocation(nullptr), keys(nullptr), size(0), capacity(0) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the array.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr ArrayDaryHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : ArrayDaryHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr ArrayDaryHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return ArrayDaryHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr ~ArrayDaryHeap()
+  {
+    clear();
+    if (allocation != nullptr)
+    {
+      KeyTraits::deallocate(alloc, allocation, allocation_size(capacity));
+    }
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The key is appended to the array and sifted up to its place.
+   *
+   * The time complexity of this operation is O(log_D n) amortized, where n is the number
+   * of keys in the heap.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly in its slot of the array.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    if (size == capacity)
+    {
+      reserve(std::max(min_capacity, 2 * capacity));
+    }
+    KeyTraits::construct(alloc, keys + size, std::forward<Args>(args)...);
+    sift_up(size);
+    ++size;
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The array is kept for later insertions.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap, or O(1) if `T` is trivially destructible.
+   */
+  constexpr void clear() noexcept
+  {
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      KeyTraits::destroy(alloc, keys + i);
+    }
+    size = 0;
+  }
+
+  /**
+   * @brief Makes room for at least `new_capacity` keys.
+   *
+   * The time complexity of this operation is O(n) if the array is reallocated, where n is
+   * the number of keys in the heap, and O(1) otherwise.
+   *
+   * @param new_capacity The number of keys the heap should be able to hold without
+   * reallocating.
+   */
+  constexpr void reserve(std::size_t new_capacity)
+  {
+    if (new_capacity <= capacity)
+    {
+      return;
+    }
+
+    T *new_allocation = KeyTraits::allocate(alloc, allocation_size(new_capacity));
+    T *new_slots = new_allocation;
+    if !consteval
+    {
+      const std::size_t misalignment = reinterpret_cast<std::uintptr_t>(new_allocation) % cache_line;
+      if (misalignment != 0 && (cache_line - misalignment) % sizeof(T) == 0)
+      {
+        new_slots += (cache_line - misalignment) / sizeof(T);
+      }
+    }
+    T *new_keys = new_slots + padding;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      KeyTraits::construct(alloc, new_keys + i, std::move(keys[i]));
+      KeyTraits::destroy(alloc, keys + i);
+    }
+    if (allocation != nullptr)
+    {
+      KeyTraits::deallocate(alloc, allocation, allocation_size(capacity));
+    }
+
+    allocation = new_allocation;
+    keys = new_keys;
+    capacity = new_capacity;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is the root.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+    return std::cref(keys[0]);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The root is moved out, and the last key of the array is sifted down from the root.
+   *
+   * The time complexity of this operation is O(D log_D n), where n is the number of keys
+   * in the heap.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+
+    T key = std::move(keys[0]);
+    --size;
+    if (size > 0)
+    {
+      T last = std::move(keys[size]);
+      sift_down(0, std::move(last));
+    }
+    KeyTraits::destroy(alloc, keys + size);
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The arrays are swapped if the other heap holds more keys, so the smaller array is
+   * always the one being copied. Its keys are then appended, and the whole array is
+   * heapified bottom-up.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the arrays may be swapped.
+   *
+   * The time complexity of this operation is O(n + m), where n and m are the number of
+   * keys in the two heaps.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(ArrayDaryHeap &other)
+  {
+    if (other.size > size)
+    {
+      std::swap(allocation, other.allocation);
+      std::swap(keys, other.keys);
+      std::swap(size, other.size);
+      std::swap(capacity, other.capacity);
+    }
+    if (other.size == 0)
+    {
+      return;
+    }
+
+    if (size + other.size > capacity)
+    {
+      reserve(std::max(size + other.size, 2 * capacity));
+    }
+    for (std::size_t i = 0; i < other.size; ++i)
+    {
+      KeyTraits::construct(alloc, keys + size + i, std::move(other.keys[i]));
+    }
+    size += other.size;
+    other.clear();
+
+    heapify();
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys in the order they are stored in the array, i.e. in level
+   * order.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  void print() const
+  {
+    if (size == 0)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      std::cout << keys[i] << ", ";
+    }
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n log n), where n is the number of keys in
+   * the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(ArrayDaryHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(alloc);
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The keys are appended to the array, which is then heapified bottom-up.
+   *
+   * The time complexity of this operation is O(n + k), where n is the number of keys in
+   * the heap and k is the number of keys in the batch.
+   *
+   * @param batch The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> batch)
+  {
+    reserve(size + batch.size());
+    for (T &key : batch)
+    {
+      KeyTraits::construct(alloc, keys + size, std::move(key));
+      ++size;
+    }
+    heapify();
+  }
+
+private:
+  [[no_unique_address]] KeyAllocator alloc; ///< The allocator of the array.
+  T *allocation;                            ///< The allocated array, including the padding and the alignment slack.
+  T *keys;                                  ///< The keys of the heap, in level order.
+  std::size_t size;                         ///< The number of keys in the heap.
+  std::size_t capacity;                     ///< The number of keys the array can hold.
+
+  /**
+   * @brief Returns the number of slots to allocate for the given capacity, including the
+   * padding before the root and the slack for aligning the array to a cache line.
+   */
+  static constexpr std::size_t allocation_size(std::size_t key_count) noexcept
+  {
+    return key_count + padding + slack;
+  }
+
+  /**
+   * @brief Moves the key at the given index up to its place.
+   *
+   * The time complexity of this operation is O(log_D n).
+   *
+   * @param index The index of the key to sift up.
+   */
+  constexpr void sift_up(std::size_t index)
+  {
+    T key = std::move(keys[index]);
+    while (index > 0)
+    {
+      std::size_t parent = (index - 1) / D;
+      if (!(key < keys[parent]))
+      {
+        break;
+      }
+      keys[index] = std::move(keys[parent]);
+      index = parent;
+    }
+    keys[index] = std::move(key);
+  }
+
+  /**
+   * @brief Moves a key down from the given index to its place.
+   *
+   * The key at `index` is treated as a hole; at every step the smallest child is moved
+   * into the hole, until `key` is not greater than it.
+   *
+   * The time complexity of this operation is O(D log_D n).
+   *
+   * @param index The index of the hole to start from.
+   * @param key The key to place.
+   */
+  constexpr void sift_down(std::size_t index, T key)
+  {
+    while (true)
+    {
+      const std::size_t first = D * index + 1;
+      if (first >= size)
+      {
+        break;
+      }
+      const std::size_t last = std::min(first + D, size);
+
+      std::size_t min = first;
+      for (std::size_t child = first + 1; child < last; ++child)
+      {
+        if (keys[child] < keys[min])
+        {
+          min = child;
+        }
+      }
+      if (!(keys[min] < key))
+      {
+        break;
+      }
+      keys[index] = std::move(keys[min]);
+      index = min;
+    }
+    keys[index] = std::move(key);
+  }
+
+  /**
+   * @brief Restores the heap property of the whole array, bottom-up.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr void heapify()
+  {
+    if (size < 2)
+    {
+      return;
+    }
+    for (std::size_t index = (size - 2) / D + 1; index-- > 0;)
+    {
+      T key = std::move(keys[index]);
+      sift_down(index, std::move(key));
+    }
+  }
+}; // class ArrayDaryHeap
+
+namespace pmr
+{
+  /**
+   * @brief An `ArrayDaryHeap` that allocates its array from a `std::pmr::memory_resource`.
+   */
+  template <typename T, std::size_t D = 4>
+  using ArrayDaryHeap = ::ArrayDaryHeap<T, D, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // ARRAY_DARY_HEAP_H
@@ -0,0 +1,90 @@
+#ifndef DOUBLE_ENDED_MERGEABLE_HEAP_H
+#define DOUBLE_ENDED_MERGEABLE_HEAP_H
+
+#include "mergeable_heap.h"
+
+#include <concepts>
+#include <functional>
+#include <optional>
+
+/**
+ * @brief The operations of a double-ended mergeable heap, checked at compile time.
+ *
+ * @details A type models `double_ended_mergeable_heap` if it models `mergeable_heap`, and
+ * also supports MAXIMUM and EXTRACT-MAX with the signatures of `DoubleEndedMergeableHeap`.
+ */
+template <typename H>
+concept double_ended_mergeable_heap = mergeable_heap<H> && requires(H &heap, const H &const_heap) {
+  { const_heap.maximum() } -> std::same_as<std::optional<std::reference_wrapper<const typename H::value_type>>>;
+  { heap.extract_max() } -> std::same_as<std::optional<typename H::value_type>>;
+};
+
+/**
+ * @class DoubleEndedMergeableHeap
+ *
+ * @brief A mergeable heap that can also access and remove its maximum key.
+ *
+ * @details In addition to the operations of a mergeable heap, a double-ended mergeable heap
+ * supports the following operations:
+ * 1. MAXIMUM returns the element with the maximum key in the heap.
+ * 2. EXTRACT-MAX removes and returns the element with the maximum key in the heap.
+ *
+ * This is useful for bounded priority queues, which evict their largest element when they
+ * are full, while also popping their smallest element, without keeping two heaps.
+ *
+ * Like `MergeableHeap`, this is a runtime-polymorphic interface; a concrete double-ended
+ * heap is used through it by wrapping it in a `PolymorphicDoubleEndedHeap`.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method.
+ */
+template <typename T>
+class DoubleEndedMergeableHeap : public MergeableHeap<T>
+{
+public:
+  /**
+   * Returns the maximum key in the heap.
+   */
+  constexpr virtual std::optional<std::reference_wrapper<const T>> maximum() const = 0;
+
+  /**
+   * Removes and returns the maximum key in the heap.
+   */
+  constexpr virtual std::optional<T> extract_max() = 0;
+};
+
+/**
+ * @class PolymorphicDoubleEndedHeap
+ *
+ * @brief A type-erased adapter that exposes a concrete double-ended heap through the
+ * `DoubleEndedMergeableHeap` interface.
+ *
+ * @tparam H The type of the wrapped heap.
+ */
+template <double_ended_mergeable_heap H>
+class PolymorphicDoubleEndedHeap final : public PolymorphicHeap<H, DoubleEndedMergeableHeap<typename H::value_type>>
+{
+private:
+  using T = typename H::value_type;
+
+public:
+  using PolymorphicHeap<H, DoubleEndedMergeableHeap<T>>::PolymorphicHeap;
+
+  /**
+   * @brief Returns the maximum key in the wrapped heap.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> maximum() const override
+  {
+    return this->heap.maximum();
+  }
+
+  /**
+   * @brief Removes and returns the maximum key in the wrapped heap.
+   */
+  constexpr std::optional<T> extract_max() override
+  {
+    return this->heap.extract_max();
+  }
+};
+
+#endif // DOUBLE_ENDED_MERGEABLE_HEAP_H
@@ -0,0 +1,450 @@
+#ifndef EAGER_BINOMIAL_HEAP_H
+#define EAGER_BINOMIAL_HEAP_H
+
+#include "mergeable_heap.h"
+#include "node_pool.h"
+#include "binomial_tree.h"
+#include "forest.h"
+
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class EagerBinomialHeap
+ *
+ * @brief A binomial heap with O(log n) worst-case operations.
+ *
+ * @details This mergeable heap is implemented using the binomial heap data structure, just
+ * like `LazyBinomialHeap`, and is built from the same nodes and links. Unlike the lazy
+ * heap, it links trees of the same degree as soon as they appear, so the root list holds
+ * at most one tree per degree at all times, i.e. at most log2(n + 1) trees. The root list
+ * is a null-terminated singly linked list in ascending order of degree, and two heaps are
+ * merged like adding two binary numbers. Hence insert, merge and extract_min each take
+ * O(log n) time in the worst case, and no single operation pays for the work deferred by
+ * others.
+ *
+ * The nodes of the heap are allocated from a per-heap `NodePool`.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method.
+ * @tparam Allocator The allocator used by the node pool to allocate its slabs.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class EagerBinomialHeap final : public MergeableHeapBase<EagerBinomialHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<EagerBinomialHeap, T>; ///< The non-virtual base of the heap.
+  friend Base;
+
+private:
+  /**
+   * @brief A node in the heap.
+   *
+   * The root list is null-terminated and singly linked through `sibling`.
+   */
+  using Node = binomial::Node<T>;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr EagerBinomialHeap() : EagerBinomialHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit EagerBinomialHeap(const Allocator &alloc) noexcept : nodes(alloc), head(nullptr), min(nullptr) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr EagerBinomialHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : EagerBinomialHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr EagerBinomialHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return EagerBinomialHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, or O(s) if `T` is trivially destructible, where s is the number of slabs.
+   */
+  constexpr ~EagerBinomialHeap()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The new node is merged into the root list as a tree of degree 0, which carries into
+   * the trees of degree 1, 2, ... like incrementing a binary counter.
+   *
+   * The time complexity of this operation is O(log n) in the worst case, and O(1)
+   * amortized.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    Node *node = nodes.create(std::in_place, std::forward<Args>(args)...);
+    if (head == nullptr || head->degree > 0) // no carry: the roots stay the same
+    {
+      node->sibling = head;
+      head = node;
+      if (min == nullptr || node->key < min->key)
+      {
+        min = node;
+      }
+    }
+    else
+    {
+      head = unite(head, node);
+      update_min();
+    }
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The time complexity of this operation is O(1) if `T` is trivially destructible, and
+   * O(n) otherwise, where n is the number of nodes in the heap.
+   */
+  constexpr void clear() noexcept
+  {
+    if consteval
+    {
+      forest::destroy(head, nodes);
+    }
+    else
+    {
+      if constexpr (std::is_trivially_destructible_v<Node>)
+      {
+        nodes.release();
+      }
+      else
+      {
+        forest::destroy(head, nodes);
+      }
+    }
+
+    head = min = nullptr;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the root with the minimum key
+   * is found again after every operation that changes the root list.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (min == nullptr)
+    {
+      return std::nullopt;
+    }
+    return std::cref(min->key);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The minimum root is unlinked from the root list. Its children, which form a list in
+   * descending order of degree, are reversed into a root list of their own, which is then
+   * merged back into the heap.
+   *
+   * The time complexity of this operation is O(log n) in the worst case.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    Node *min_node = min;
+    if (min_node == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    Node **link = &head;
+    while (*link != min_node)
+    {
+      link = &(*link)->sibling;
+    }
+    *link = min_node->sibling;
+
+    Node *children = nullptr;
+    for (Node *child = min_node->child; child != nullptr;)
+    {
+      Node *next = child->sibling;
+      child->sibling = children;
+      children = child;
+      child = next;
+    }
+
+    head = unite(head, children);
+    update_min();
+
+    T key = std::move(min_node->key);
+    nodes.destroy(min_node);
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The root lists of both heaps are merged in ascending order of degree, and trees of the
+   * same degree are linked, like adding two binary numbers. The node pool of the other
+   * heap is spliced into the node pool of this heap.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the slabs of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
+   * The time complexity of this operation is O(log n + log m) in the worst case, where n
+   * and m are the number of nodes in the two heaps.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(EagerBinomialHeap &other)
+  {
+    head = unite(head, other.head);
+    update_min();
+    nodes.splice(other.nodes);
+
+    other.head = other.min = nullptr;
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys of the nodes in the heap using a breadth-first traversal,
+   * starting from the roots of all trees.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
+   */
+  void print() const
+  {
+    if (head == nullptr)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    std::queue<Node *> q;
+    q.push(head);
+    while (!q.empty())
+    {
+      for (Node *curr = q.front(); curr != nullptr; curr = curr->sibling)
+      {
+        std::cout << curr->key << ", ";
+        if (curr->child != nullptr)
+        {
+          q.push(curr->child);
+        }
+      }
+      q.pop();
+    }
+
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n log n), where n is the number of nodes
+   * in the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(EagerBinomialHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return nodes.get_allocator();
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The keys are built into perfect binomial trees using a degree table, which behaves
+   * like incrementing a binary counter, and the resulting root list is merged into the
+   * heap once.
+   *
+   * The time complexity of this operation is O(k + log n), where k is the number of keys.
+   *
+   * @param keys The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> keys)
+  {
+    DegreeTable degrees{};
+    int max_degree = -1;
+    for (T &key : keys)
+    {
+      Node *tree = nodes.create(std::in_place, std::move(key));
+      while (degrees[tree->degree] != nullptr)
+      {
+        tree = binomial::link(tree, std::exchange(degrees[tree->degree], nullptr));
+      }
+      degrees[tree->degree] = tree;
+      max_degree = std::max(max_degree, tree->degree);
+    }
+
+    Node *trees = nullptr;
+    for (int i = max_degree; i >= 0; --i)
+    {
+      if (Node *tree = degrees[i]; tree != nullptr)
+      {
+        tree->sibling = trees;
+        trees = tree;
+      }
+    }
+
+    head = unite(head, trees);
+    update_min();
+  }
+
+private:
+  using DegreeTable = std::array<Node *, std::numeric_limits<size_t>::digits>; ///< Trees indexed by degree.
+
+  NodePool<Node, Allocator> nodes; ///< The pool that the nodes of the heap are allocated from.
+  Node *head;                      ///< The root of the lowest degree, which starts the root list.
+  Node *min;                       ///< The root with the minimum key.
+
+  /**
+   * @brief Finds the root with the minimum key.
+   *
+   * The time complexity of this operation is O(log n), as there are at most log2(n + 1)
+   * roots.
+   */
+  constexpr void update_min()
+  {
+    min = head;
+    for (Node *root = head; root != nullptr; root = root->sibling)
+    {
+      if (root->key < min->key)
+      {
+        min = root;
+      }
+    }
+  }
+
+  /**
+   * @brief Merges two root lists in ascending order of degree, and links trees of the same
+   * degree.
+   *
+   * The two lists are first merged like two sorted lists, so each degree appears at most
+   * twice. Then the merged list is scanned, and whenever two consecutive trees have the
+   * same degree, they are linked, unless a third tree of the same degree follows, in which
+   * case the last two are linked instead, like a carry in binary addition.
+   *
+   * The time complexity of this operation is O(log n + log m), where n and m are the
+   * number of nodes in the two heaps.
+   *
+   * @param list1 The first root list, or `nullptr`.
+   * @param list2 The second root list, or `nullptr`.
+   * @return The merged root list, or `nullptr` if both lists are empty.
+   */
+  static constexpr Node *unite(Node *list1, Node *list2)
+  {
+    Node *result = nullptr;
+    Node **tail = &result;
+    while (list1 != nullptr && list2 != nullptr)
+    {
+      Node *&smaller = list2->degree < list1->degree ? list2 : list1;
+      *tail = smaller;
+      tail = &smaller->sibling;
+      smaller = smaller->sibling;
+    }
+    *tail = list1 != nullptr ? list1 : list2;
+
+    Node *prev = nullptr;
+    Node *curr = result;
+    while (curr != nullptr && curr->sibling != nullptr)
+    {
+      Node *next = curr->sibling;
+      if (curr->degree != next->degree || (next->sibling != nullptr && next->sibling->degree == curr->degree))
+      {
+        prev = curr;
+        curr = next;
+        continue;
+      }
+
+      Node *after = next->sibling;
+      curr = binomial::link(curr, next);
+      curr->sibling = after;
+      (prev == nullptr ? result : prev->sibling) = curr;
+    }
+    return result;
+  }
+}; // class EagerBinomialHeap
+
+namespace pmr
+{
+  /**
+   * @brief An `EagerBinomialHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T>
+  using EagerBinomialHeap = ::EagerBinomialHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // EAGER_BINOMIAL_HEAP_H
@@ -0,0 +1,38 @@
+#ifndef FIBONACCI_HEAP_H
+#define FIBONACCI_HEAP_H
+
+#include "lazy.h"
+
+#include <functional>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @brief A mergeable heap that supports decreasing and erasing keys in place.
+ *
+ * @details A Fibonacci heap is a lazy binomial heap whose nodes can be cut from their
+ * parents: it keeps a circular doubly linked root list of heap-ordered trees, which is
+ * only consolidated during extract_min, and a node that loses a second child is cut as
+ * well (cascading cuts). `LazyBinomialHeap` does exactly that since it supports
+ * `decrease_key` and `erase`, so `FibonacciHeap` is the same heap, ordered by `<`.
+ *
+ * `push` returns a handle to the inserted key, which stays valid until the key is removed
+ * from the heap. A handle can be used to decrease its key in O(1) amortized time with
+ * `decrease_key`, or to remove it with `erase`.
+ *
+ * @tparam T The type of the elements stored in the heap.
+ * @tparam Allocator The allocator used by the node pool to allocate its slabs.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+using FibonacciHeap = LazyBinomialHeap<T, std::less<>, std::identity, Allocator>;
+
+namespace pmr
+{
+  /**
+   * @brief A `FibonacciHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T>
+  using FibonacciHeap = ::FibonacciHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // FIBONACCI_HEAP_H
@@ -0,0 +1,95 @@
+#ifndef FOREST_H
+#define FOREST_H
+
+/**
+ * @brief Operations on the forests of heap-ordered trees shared by the node-based heaps.
+ *
+ * @details The heaps built from trees of nodes, i.e. `PairingHeap`, `LeftistHeap`,
+ * `EagerBinomialHeap` and `LazyBinomialHeap`, keep their nodes in a `NodePool` and link
+ * them by pointers. The operations that do not depend on how the trees are ordered or
+ * balanced live here, so that every heap uses the same implementation.
+ */
+namespace forest
+{
+  /**
+   * @brief Visits and destroys every node of a null-terminated list of binary trees.
+   *
+   * A node with a left child is rotated right until the current node has no left child, at
+   * which point it is handed to `visit`, destroyed, and the traversal continues with its
+   * right child. This way, no recursion and no auxiliary memory are needed, and destroying
+   * a degenerate, deep tree does not overflow the stack.
+   *
+   * If `visit` throws, the nodes that have not been visited yet are neither visited nor
+   * destroyed.
+   *
+   * The time complexity of this operation is O(k), where k is the number of nodes in the
+   * destroyed trees.
+   *
+   * @param node The first tree in the list, or `nullptr`.
+   * @param pool The pool the nodes are returned to.
+   * @param left The member pointing to the left child of a node.
+   * @param right The member pointing to the right child of a node.
+   * @param visit The function called with every node right before it is destroyed, e.g.
+   * to move its key out.
+   */
+  template <typename Node, typename Pool, typename Visit>
+  constexpr void drain(Node *node, Pool &pool, Node *Node::*left, Node *Node::*right, Visit visit) noexcept(noexcept(visit(node)))
+  {
+    while (node != nullptr)
+    {
+      if (Node *child = node->*left; child != nullptr)
+      {
+        node->*left = child->*right; // rotate right: the left child becomes the parent
+        child->*right = node;
+        node = child;
+      }
+      else
+      {
+        Node *next = node->*right;
+        visit(node);
+        pool.destroy(node);
+        node = next;
+      }
+    }
+  }
+
+  /**
+   * @brief Destroys every tree in a null-terminated list of binary trees.
+   *
+   * The trees are destroyed by `drain`, without visiting their nodes.
+   *
+   * The time complexity of this operation is O(k), where k is the number of nodes in the
+   * destroyed trees.
+   *
+   * @param node The first tree in the list, or `nullptr`.
+   * @param pool The pool the nodes are returned to.
+   * @param left The member pointing to the left child of a node.
+   * @param right The member pointing to the right child of a node.
+   */
+  template <typename Node, typename Pool>
+  constexpr void destroy(Node *node, Pool &pool, Node *Node::*left, Node *Node::*right) noexcept
+  {
+    drain(node, pool, left, right, [](Node *) noexcept {});
+  }
+
+  /**
+   * @brief Destroys every tree in a null-terminated list of trees in the left-child,
+   * right-sibling representation.
+   *
+   * Viewed as a binary tree, the first child of a node is its left child, and its next
+   * sibling is its right child, so the trees are destroyed by rotations as above.
+   *
+   * The time complexity of this operation is O(k), where k is the number of nodes in the
+   * destroyed trees.
+   *
+   * @param node The first tree in the list, or `nullptr`.
+   * @param pool The pool the nodes are returned to.
+   */
+  template <typename Node, typename Pool>
+  constexpr void destroy(Node *node, Pool &pool) noexcept
+  {
+    destroy(node, pool, &Node::child, &Node::sibling);
+  }
+} // namespace forest
+
+#endif // FOREST_H
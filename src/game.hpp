@@ -1,3 +1,4 @@
+#include <chrono>
 #include <string>
 #include <memory>
 #include <iostream>
@@ -9,6 +10,7 @@
 #include <vector>
 #include <cstring>
 
+#include "loader.h"
 #include "sorted.h"
 #include "unsorted.h"
 #include "lazy.h"
@@ -256,37 +258,36 @@ private:
     print_end();
   }
 
-  void read_line(Heap *heap, const std::string &str)
-  {
-    static constexpr char delimiter = ' ';
-    std::stringstream ss(str);
-    std::string number;
-    while (std::getline(ss, number, delimiter))
-    {
-      int res = std::stoi(number);
-      heap->insert(res);
-    }
-  }
-
   void read_file(const std::string &filepath)
   {
-    std::ifstream file(filepath);
+    const auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(filepath);
     if (!file.is_open())
     {
       throw std::runtime_error("The land of " + filepath + " does not appear in my maps!");
     }
 
-    std::string line1, line2;
+    std::string_view text = file.view();
     // Read the first two lines, ignore the rest
-    if (std::getline(file, line1) && std::getline(file, line2))
-    {
-      read_line(heap1, line1);
-      read_line(heap2, line2);
-    }
-    else
+    auto line1 = next_line(text);
+    auto line2 = next_line(text);
+    if (!line1 || !line2)
     {
       throw std::runtime_error("Beep beep boop boop... I can't read this file!");
     }
+
+    // Parse both lines before inserting, so that a bad file leaves the heaps untouched
+    std::vector<int> keys1 = parse_integers(*line1);
+    std::vector<int> keys2 = parse_integers(*line2);
+    heap1->insert_range(keys1);
+    heap2->insert_range(keys2);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double megabytes = static_cast<double>(line1->size() + line2->size()) / (1024.0 * 1024.0);
+    ColorManager::set_info();
+    std::cout << "I read " << keys1.size() + keys2.size() << " numbers (" << megabytes << " MB) in "
+              << elapsed.count() * 1000.0 << " ms, that is " << megabytes / elapsed.count() << " MB/s!\n";
   }
 
   void init_sorted()
@@ -481,7 +482,7 @@ private:
     }
 
     delete heap;
-    heap = sorted ? static_cast<Heap *>(new SortedLinkedHeap<int>()) : static_cast<Heap *>(new UnsortedLinkedHeap<int>());
+    heap = sorted ? static_cast<Heap *>(new PolymorphicHeap<SortedLinkedHeap<int>>()) : static_cast<Heap *>(new PolymorphicHeap<UnsortedLinkedHeap<int>>());
   }
 
   void execute_insert(Heap *heap)
@@ -2,14 +2,19 @@
 #define LAZY_BINOMIAL_HEAP_H
 
 #include "mergeable_heap.h"
+#include "node_pool.h"
+#include "forest.h"
+#include "root_list.h"
 
-#include <vector>
-#include <algorithm>
+#include <functional>
+#include <initializer_list>
 #include <optional>
-#include <cmath>
 #include <queue>
-#include <memory>
+#include <stdexcept>
 #include <utility>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
 
 /**
  * @class LazyBinomialHeap
@@ -21,55 +26,117 @@
  * heap-ordered tree. A binomial tree of order k is a tree with 2^k nodes, where each
  * node has a key and a pointer to its parent and its leftmost child. The binomial heap
  * is a collection of binomial trees of different orders, where each order is represented
- * by a linked list of binomial trees. The root list of the heap is a linked list of the
- * roots of the binomial trees in the heap, hence its size is logarithmic in the number of
- * nodes in the heap in the average case. The current implementation of the binomial heap
+ * by a linked list of binomial trees. The root list of the heap is a circular doubly linked
+ * list of the roots of the binomial trees in the heap, hence its size is logarithmic in the
+ * number of nodes in the heap in the average case, and any root can be unlinked from it in
+ * constant time. The current implementation of the binomial heap
  * is lazy, meaning that the heap is consolidated only when needed, during the extract_min
  * operation. This allows for O(1) insertions and merges, and an amortized O(log n) extract_min.
  * Amortized analysis is used to analyze the time complexity of the consolidate operation,
  *
+ * The nodes of the heap are allocated from a per-heap `NodePool`, so that insertions and
+ * extractions recycle the memory of previously extracted nodes instead of calling the
+ * global allocator for every operation.
+ *
+ * `push` returns a handle to the inserted key, which can later be used to decrease the key
+ * with `decrease_key`, or to remove it with `erase`. To support this, every node links to
+ * its parent, and the children of a node are doubly linked, so a node whose decreased key
+ * is smaller than its parent's key is cut from its tree and moved to the root list in
+ * constant time. As in a Fibonacci heap, a node that loses a second child is cut as well
+ * (cascading cuts), so the trees are no longer strictly binomial once keys are decreased
+ * or erased, but the degree of every node stays logarithmic in the size of its subtree,
+ * and decrease_key takes O(1) amortized time. This makes the heap a Fibonacci heap, which
+ * is why `FibonacciHeap` (fibonacci.h) is an alias of it.
+ *
  * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
- * moved into the heap in the insert method.
+ * moved into the heap in the insert method, and move-assignable, as it is reassigned in
+ * the decrease_key method.
+ * @tparam Compare The strict weak ordering of the projected keys. A stateless comparator
+ * takes no space in the heap.
+ * @tparam Projection The projection applied to the keys before they are compared.
+ * @tparam Allocator The allocator used by the node pool to allocate its slabs. With a
+ * `std::pmr::polymorphic_allocator`, all nodes of a heap live in the memory resource it
+ * was given.
  */
-template <typename T>
-class LazyBinomialHeap : public MergeableHeap<T>
+template <typename T, typename Compare = std::less<>, typename Projection = std::identity, typename Allocator = std::allocator<T>>
+class LazyBinomialHeap final : public MergeableHeapBase<LazyBinomialHeap<T, Compare, Projection, Allocator>, T, Compare, Projection>
 {
+  using Base = MergeableHeapBase<LazyBinomialHeap, T, Compare, Projection>; ///< The non-virtual base of the heap.
+  friend Base;
+
 private:
   /**
    * @struct Node
    * @brief A node in the heap.
    *
-   * This struct represents a node in the heap. Each node contains a key of type `T`,
-   * a degree representing the number of children, and pointers to its sibling and child nodes.
-   *
-   * @note The linked-list is implemented using the left-child, right-sibling (LCRS) idiom.
-   *
-   * @tparam T The type of the key stored in the node. `T` must be movable, as it is moved
-   * into the node in the constructor.
+   * @note The root list is circular and doubly linked through `sibling` and `prev`. The
+   * children of a node form a null-terminated list in descending order of degree, which is
+   * doubly linked as well, with `nullptr` before the first child.
    */
   struct Node
   {
-    T key;                         ///< The key stored in the node.
-    int degree;                    ///< The degree of the binomial tree represented by this node.
-    std::unique_ptr<Node> sibling; ///< A pointer to the node's sibling.
-    std::unique_ptr<Node> child;   ///< A pointer to the node's first child.
+    T key;         ///< The key stored in the node.
+    int degree;    ///< The number of children of the node.
+    bool marked;   ///< Whether the node has lost a child since it became a child itself.
+    Node *parent;  ///< A pointer to the node's parent, or `nullptr` if the node is a root.
+    Node *sibling; ///< A pointer to the node's next sibling.
+    Node *prev;    ///< A pointer to the node's previous sibling.
+    Node *child;   ///< A pointer to the node's first child.
 
     /**
-     * @brief Constructs a new node with the given key.
+     * @brief Constructs a new node whose key is constructed in place from the given arguments.
      *
-     * This constructor initializes a binomial tree of degree 0 with the given key.
+     * This constructor initializes a tree of degree 0.
      *
-     * @param key The key to store in the node. This key is moved into the node.
+     * @param args The arguments forwarded to the constructor of the key.
      */
-    constexpr Node(T key) noexcept(std::is_nothrow_move_constructible_v<T>) : key(std::move(key)), degree(0), sibling(nullptr), child(nullptr) {}
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) : key(std::forward<Args>(args)...), degree(0), marked(false), parent(nullptr), sibling(nullptr), prev(nullptr), child(nullptr) {}
+  };
 
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @class handle_type
+   * @brief A handle to a key in the heap.
+   *
+   * A handle is returned by `push` and `emplace`, and stays valid until its key is extracted
+   * or erased, or the heap is cleared, sorted or destroyed. Merging a heap into another keeps
+   * its handles valid; they then refer to keys of the heap that was merged into.
+   */
+  class handle_type
+  {
+  public:
     /**
-     * @brief Destroys the node.
-     *
-     * This destructor deletes the node's sibling and child, if they exist. This will
-     * recursively delete all nodes in the sibling and child subtrees.
+     * @brief Constructs a handle that does not refer to any key.
+     */
+    constexpr handle_type() noexcept = default;
+
+    /**
+     * @brief Returns the key the handle refers to.
+     */
+    constexpr const T &operator*() const noexcept
+    {
+      return node->key;
+    }
+
+    /**
+     * @brief Accesses the key the handle refers to.
      */
-    constexpr ~Node() = default;
+    constexpr const T *operator->() const noexcept
+    {
+      return &node->key;
+    }
+
+    constexpr bool operator==(const handle_type &) const noexcept = default;
+
+  private:
+    friend class LazyBinomialHeap;
+
+    constexpr explicit handle_type(Node *node) noexcept : node(node) {}
+
+    Node *node = nullptr; ///< The node holding the key.
   };
 
 private:
@@ -82,60 +149,274 @@ private:
    * The time complexity of this operation is O(1).
    *
    * @param key The key to store in the heap. This key is moved into the heap.
+   * @param comp The comparator used to order the keys.
+   * @param proj The projection applied to the keys before they are compared.
+   * @param alloc The allocator used to allocate the nodes of the heap.
    */
-  constexpr LazyBinomialHeap(T key) : head(std::make_unique<Node>(std::move(key))), tail(head.get()), min(head.get()), size(1) {}
+  constexpr LazyBinomialHeap(T key, const Compare &comp, const Projection &proj, const Allocator &alloc) : LazyBinomialHeap(comp, proj, alloc)
+  {
+    insert(std::move(key));
+  }
 
 public:
   /**
    * @brief Constructs a new empty heap.
    *
-   * This constructor initializes the heap to be empty. The head, tail, and minimum node
-   * pointers are all set to `nullptr`, and the size is set to 0.
+   * This constructor initializes the heap to be empty. The minimum node pointer, which is
+   * also the entry point to the root list, is set to `nullptr`, and the size is set to 0.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr LazyBinomialHeap() : LazyBinomialHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit LazyBinomialHeap(const Allocator &alloc) noexcept : LazyBinomialHeap(Compare(), Projection(), alloc) {}
+
+  /**
+   * @brief Constructs a new empty heap that orders its keys using the given comparator and
+   * projection.
    *
    * The time complexity of this operation is O(1).
+   *
+   * @param comp The comparator used to order the keys.
+   * @param proj The projection applied to the keys before they are compared.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit LazyBinomialHeap(const Compare &comp, const Projection &proj = Projection(), const Allocator &alloc = Allocator())
+      : comp(comp), proj(proj), nodes(alloc), min(nullptr), size(0) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
    */
-  constexpr LazyBinomialHeap() noexcept : head(nullptr), tail(nullptr), min(nullptr), size(0) {}
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr LazyBinomialHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : LazyBinomialHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr LazyBinomialHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return LazyBinomialHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
 
   /**
    * @brief Destroys the heap.
    *
-   * This destructor deletes the head node of the heap, which recursively deletes all
-   * nodes in the heap.
+   * This destructor clears the heap, and then the node pool releases the memory of the
+   * nodes. The nodes are destroyed iteratively, so destroying a heap with millions of
+   * unconsolidated nodes does not overflow the stack.
    *
-   * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, or O(s) if `T` is trivially destructible, where s is the number of slabs.
    */
-  constexpr ~LazyBinomialHeap() = default;
+  constexpr ~LazyBinomialHeap()
+  {
+    clear();
+  }
 
   /**
-   * @brief Inserts a key into the heap.
+   * @brief Constructs a new heap that takes over the slabs of another heap.
+   *
+   * @note The other heap is left empty.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to move from.
+   */
+  constexpr LazyBinomialHeap(LazyBinomialHeap &&other) noexcept
+      : comp(std::move(other.comp)), proj(std::move(other.proj)), nodes(std::move(other.nodes)),
+        min(std::exchange(other.min, nullptr)), size(std::exchange(other.size, 0)) {}
+
+  /**
+   * @brief Replaces the keys of this heap with the keys of another heap.
+   *
+   * The keys of this heap are destroyed. Like the standard containers, the heap then takes
+   * over the slabs of the other heap if its allocator propagates on move assignment or
+   * compares equal to the allocator of the other heap. Otherwise, e.g. for two
+   * `std::pmr::polymorphic_allocator`s with different memory resources, the keys are moved
+   * one by one into nodes allocated by this heap, which invalidates the handles to the keys
+   * of the other heap. If moving a key throws, the keys not moved yet are lost.
+   *
+   * @note The other heap is left empty.
+   *
+   * The time complexity of this operation is O(1), or O(m) if the keys are moved one by
+   * one, where m is the number of nodes in the other heap, plus the time needed to destroy
+   * the keys of this heap.
+   *
+   * @param other The heap to move from.
+   * @return A reference to this heap.
+   */
+  constexpr LazyBinomialHeap &operator=(LazyBinomialHeap &&other) noexcept(NodePool<Node, Allocator>::always_adopts)
+  {
+    if (this == &other)
+    {
+      return *this;
+    }
+
+    clear();
+    comp = std::move(other.comp);
+    proj = std::move(other.proj);
+    if (nodes.can_adopt(other.nodes))
+    {
+      nodes = std::move(other.nodes);
+      min = std::exchange(other.min, nullptr);
+      size = std::exchange(other.size, 0);
+    }
+    else
+    {
+      Node *roots = std::exchange(other.min, nullptr);
+      other.size = 0;
+      if (roots != nullptr)
+      {
+        roots->prev->sibling = nullptr; // break the circle
+      }
+      forest::drain(roots, other.nodes, &Node::child, &Node::sibling, [this](Node *node)
+                    { emplace(std::move(node->key)); });
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Swaps the keys of this heap with the keys of another heap.
+   *
+   * The comparators and projections are swapped as well, and so are the node pools, along
+   * with their allocators if they propagate on swap.
+   *
+   * @pre The allocators of both heaps compare equal, unless they propagate on swap, as for
+   * the standard containers. This is checked by an assertion.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to swap with.
+   */
+  constexpr void swap(LazyBinomialHeap &other) noexcept
+  {
+    std::swap(comp, other.comp);
+    std::swap(proj, other.proj);
+    nodes.swap(other.nodes);
+    std::swap(min, other.min);
+    std::swap(size, other.size);
+  }
+
+  /**
+   * @brief Swaps the keys of two heaps.
+   */
+  friend constexpr void swap(LazyBinomialHeap &a, LazyBinomialHeap &b) noexcept
+  {
+    a.swap(b);
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
    *
    * This method inserts a new key into the heap and updates the minimum accordingly.
    *
    * The time complexity of this operation is O(1), because it only involves creating
-   * a new node and updating the head and minimum pointers. The heap is not consolidated
+   * a new node, splicing it into the root list and updating the minimum pointer. The heap is not consolidated
    * after each insertion, so the heap may become unbalanced. This is fine because the
    * heap is consolidated lazily only when needed, during the extract_min operation.
    *
-   * @param key The key to insert. This key is moved into the heap.
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   * @return A handle to the inserted key.
    */
-  constexpr void insert(T key) override
+  template <typename... Args>
+  constexpr handle_type emplace(Args &&...args)
   {
-    std::unique_ptr<Node> node = std::make_unique<Node>(std::move(key));
+    Node *node = nodes.create(std::in_place, std::forward<Args>(args)...);
+    node->sibling = node->prev = node; // a root list of its own
+    ++size;
 
-    if (++size == 1) // the heap was empty
+    if (min == nullptr) // the heap was empty
     {
-      head = std::move(node);
-      tail = min = head.get();
-      return;
+      min = node;
+      return handle_type(node);
+    }
+
+    root_list::splice(min, node); // concatenate node to the end of the root list
+
+    if (less(node->key, min->key)) // update the minimum if needed
+    {
+      min = node;
     }
+    return handle_type(node);
+  }
+
+  /**
+   * @brief Inserts a key into the heap and returns a handle to it.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   * @return A handle to the inserted key.
+   */
+  constexpr handle_type push(T key)
+  {
+    return emplace(std::move(key));
+  }
 
-    tail->sibling = std::move(node); // concatenate node to the end of the root list
-    tail = tail->sibling.get();      // update the tail pointer
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
 
-    if (key < min->key) // update the minimum if needed
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * If `T` is trivially destructible, the nodes do not need to be visited at all: the
+   * node pool simply forgets about them, and its slabs are reused by later insertions.
+   * Otherwise, every node is destroyed iteratively.
+   *
+   * The time complexity of this operation is O(1) if `T` is trivially destructible, and
+   * O(n) otherwise, where n is the number of nodes in the heap.
+   */
+  constexpr void clear() noexcept
+  {
+    if consteval
+    {
+      destroy(min);
+    }
+    else
     {
-      min = tail;
+      if constexpr (std::is_trivially_destructible_v<Node>)
+      {
+        nodes.release();
+      }
+      else
+      {
+        destroy(min);
+      }
     }
+
+    min = nullptr;
+    size = 0;
   }
 
   /**
@@ -150,7 +431,7 @@ public:
    *
    * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
    */
-  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept override
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
   {
     if (min == nullptr)
     {
@@ -162,116 +443,152 @@ public:
   /**
    * @brief Removes and returns the minimum key in the heap.
    *
-   * This method removes the minimum key from the heap and returns it. If the minimum
-   * key has children, they are added to the root list. The heap is then consolidated
-   * to maintain the heap property. If the heap is empty, `std::nullopt` is returned.
+   * This method unlinks the minimum node from the root list and returns its key. The
+   * remaining roots and the children of the minimum node are then consolidated, which
+   * also finds the new minimum. If the heap is empty, `std::nullopt` is returned.
    *
    * The time complexity of this operation is O(log n) in the average case (amotrized),
    * and O(n) in the worst case where n is the number of nodes in the heap. This is
    * because the heap is consolidated after the minimum key is removed, which involves
    * linking binomial trees of the same degree until there are no two trees with the same degree.
+   * Unlinking the minimum node itself takes O(1), as the root list is doubly linked.
    *
    * @return The minimum key, or `std::nullopt` if the heap is empty.
    */
-  constexpr std::optional<T> extract_min() override
+  constexpr std::optional<T> extract_min()
   {
-    auto min_node = remove_min(); // O(log n)
-    if (min_node == nullptr)
+    if (min == nullptr)
     {
       return std::nullopt;
     }
+    return remove_root(min);
+  }
 
-    if (min_node->child != nullptr)
+  /**
+   * @brief Decreases a key in the heap.
+   *
+   * If the new key is smaller than the key of the node's parent, the node is cut from its
+   * parent and moved to the root list, followed by cascading cuts of its marked ancestors.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @param handle A handle to the key to decrease.
+   * @param key The new key. This key is moved into the heap.
+   * @throws std::invalid_argument If the new key is greater than the current key.
+   */
+  constexpr void decrease_key(handle_type handle, T key)
+  {
+    Node *node = handle.node;
+    if (less(node->key, key))
     {
-      // concatenate the children of the min node to the end of the root list
-      Node *curr = min_node->child.get();
-      Node *last_child = nullptr;
-
-      while (curr)
-      {
-        last_child = curr;
-        curr = curr->sibling.get();
-      }
-
-      if (head == nullptr)
-      {
-        head = std::move(min_node->child);
-      }
-      else
-      {
-        tail->sibling = std::move(min_node->child);
-      }
-      tail = last_child;
+      throw std::invalid_argument("The new key is greater than the current key");
     }
+    node->key = std::move(key);
 
-    consolidate(); // O(log n) amortized
-
-    update_min(); // O(log n)
+    if (Node *parent = node->parent; parent != nullptr && less(node->key, parent->key))
+    {
+      root_list::cut(node, min);
+      root_list::cascading_cut(parent, min);
+    }
+    if (less(node->key, min->key))
+    {
+      min = node;
+    }
+  }
 
-    return std::move(min_node->key);
+  /**
+   * @brief Removes a key from the heap and returns it.
+   *
+   * The node is cut from its parent, as if its key were decreased below every other key,
+   * and is then removed from the root list just like the minimum in extract_min.
+   *
+   * The time complexity of this operation is O(log n) amortized, where n is the number of
+   * nodes in the heap.
+   *
+   * @param handle A handle to the key to remove. The handle is invalidated.
+   * @return The removed key.
+   */
+  constexpr T erase(handle_type handle)
+  {
+    Node *node = handle.node;
+    if (Node *parent = node->parent; parent != nullptr)
+    {
+      root_list::cut(node, min);
+      root_list::cascading_cut(parent, min);
+    }
+    return remove_root(node);
   }
 
   /**
    * @brief Merges another heap into this heap.
    *
    * This method merges another heap into this heap. The root list of the other heap
-   * is concatenated to the root list of this heap, and the size of this heap is
+   * is spliced into the root list of this heap, and the size of this heap is
    * increased by the size of the other heap, and the minimum is updated accordingly.
    *
    * @note The other heap is left empty after the merge.
    *
-   * The time complexity of this operation is O(1), because it only involves updating
-   * the head, tail, minimum and size pointers of this heap. The heap is not consolidated
+   * The node pool of the other heap is spliced into the node pool of this heap, since
+   * this heap now owns the nodes allocated by the other heap.
+   *
+   * The time complexity of this operation is O(1), because it only involves splicing two
+   * circular lists and updating the minimum and size of this heap. The heap is not consolidated
    * after the merge, so the heap may become unbalanced. This is fine because the heap
    * is consolidated lazily only when needed, during the extract_min operation.
    *
+   * @pre The allocators of both heaps compare equal, as the slabs of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
    * @param other The heap to merge into this heap.
    */
-  constexpr void merge(MergeableHeap<T> &other) override
+  constexpr void merge(LazyBinomialHeap &other)
   {
-    LazyBinomialHeap<T> &other_heap = dynamic_cast<LazyBinomialHeap<T> &>(other);
-
-    if (min == nullptr || (other_heap.min != nullptr && other_heap.min->key < min->key))
-    {
-      min = other_heap.min;
-    }
-
-    if (head == nullptr)
-    {
-      head = std::move(other_heap.head);
-    }
-    else if (other_heap.head != nullptr)
+    if (other.min != nullptr)
     {
-      tail->sibling = std::move(other_heap.head);
+      if (min == nullptr)
+      {
+        min = other.min;
+      }
+      else
+      {
+        root_list::splice(min, other.min);
+        if (less(other.min->key, min->key))
+        {
+          min = other.min;
+        }
+      }
     }
-    tail = other_heap.tail;
 
-    size += other_heap.size;
+    size += other.size;
+    nodes.splice(other.nodes);
 
-    other_heap.tail = nullptr;
-    other_heap.size = 0;
+    other.min = nullptr;
+    other.size = 0;
   }
 
   /**
    * @brief Prints the heap.
    *
-   * This method prints the keys of the nodes in the heap using a breadth-first traversal.
+   * This method prints the keys of the nodes in the heap using a breadth-first traversal,
+   * starting from the roots of all trees.
    *
    * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
    */
   void print() const
   {
-    if (head == nullptr)
+    if (min == nullptr)
     {
       std::cout << "empty.";
       return;
     }
 
     std::queue<Node *> q;
-    if (head != nullptr)
+    Node *root = min;
+    do
     {
-      q.push(head.get());
-    }
+      q.push(root);
+      root = root->sibling;
+    } while (root != min);
 
     while (!q.empty())
     {
@@ -280,11 +597,11 @@ public:
       std::cout << curr->key << ", ";
       if (curr->child != nullptr)
       {
-        Node *child = curr->child.get();
+        Node *child = curr->child;
         q.push(child);
         while (child->sibling != nullptr)
         {
-          child = child->sibling.get();
+          child = child->sibling;
           q.push(child);
         }
       }
@@ -304,216 +621,141 @@ public:
    * in the heap. This is because the heap is sorted by extracting the minimum key n times,
    * each of which takes O(log n) time, resulting in a total time complexity of O(n log n).
    */
-  void sort() override
+  void sort()
   {
-    this->MergeableHeap<T>::sort(LazyBinomialHeap<T>{});
+    this->Base::sort(LazyBinomialHeap(comp, proj, get_allocator()));
   }
 
-private:
-  std::unique_ptr<Node> head; ///< A pointer to the first node in the root list of the heap.
-  Node *tail;                 ///< A pointer to the last node in the root list of the heap.
-  Node *min;                  ///< A pointer to the node with the minimum key in the heap.
-  size_t size;                ///< The number of nodes in the heap.
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return nodes.get_allocator();
+  }
 
   /**
-   * @brief Updates the minimum node pointer.
-   *
-   * This method updates the `min` pointer to point to the node with the minimum key
-   * in the root list. If the heap is empty, `min` is set to `nullptr`.
-   *
-   * The time complexity of this operation is O(log n), where n is the number of nodes in
-   * the heap. This is because the `min` pointer is updated by iterating over the root list,
-   * which is logarithmic in the number of nodes in the heap.
+   * @brief Returns a copy of the comparator used by the heap.
    */
-  constexpr void update_min() noexcept
+  constexpr Compare key_comp() const
   {
-    min = head.get();
-    if (min == nullptr)
-    {
-      return;
-    }
+    return comp;
+  }
 
-    Node *curr = head->sibling.get();
-    while (curr != nullptr)
-    {
-      if (curr->key < min->key)
-      {
-        min = curr;
-      }
-      curr = curr->sibling.get();
-    }
+  /**
+   * @brief Returns a copy of the projection used by the heap.
+   */
+  constexpr Projection key_proj() const
+  {
+    return proj;
   }
 
+protected:
   /**
-   * @brief Removes and returns the minimum node.
+   * @brief Inserts a batch of keys into the heap.
    *
-   * This method removes the node with the minimum key from the root list and returns
-   * it. If the heap is empty, `nullptr` is returned. The `size` is decremented by 1.
+   * Instead of adding k trees of degree 0 to the root list, the keys are built directly
+   * into perfect binomial trees: every new node is placed in a degree table exactly like
+   * during consolidation, which behaves like incrementing a binary counter. The resulting
+   * trees, one per set bit of k, are then spliced into the root list.
    *
-   * The time complexity of this operation is O(log n), where n is the number of nodes in
-   * the heap. This is because the minimum node is found by iterating over the root list,
-   * which is logarithmic in the number of nodes in the heap.
+   * The time complexity of this operation is O(k), where k is the number of keys, since
+   * incrementing a binary counter k times takes O(k) bit flips in total.
    *
-   * @return The minimum node, or `nullptr` if the heap is empty.
+   * @param keys The keys to insert into the heap. The keys are moved into the heap.
    */
-  constexpr std::unique_ptr<Node> remove_min()
+  constexpr void insert_bulk(std::span<T> keys)
   {
-    if (head == nullptr)
-    {
-      return nullptr;
-    }
-
-    Node *curr = head.get();
-    Node *prev = curr;
-    Node *min_node = head.get();
-    Node *prev_min = nullptr;
-    curr = curr->sibling.get();
-    while (curr != nullptr) // find the minimum node
+    DegreeTable degrees{};
+    int max_degree = 0;
+    for (T &key : keys)
     {
-      if (curr->key < min_node->key)
-      {
-        min_node = curr;
-        prev_min = prev;
-      }
-      prev = curr;
-      curr = curr->sibling.get();
+      root_list::place(degrees, max_degree, nodes.create(std::in_place, std::move(key)), order());
     }
+    size += keys.size();
+    root_list::splice_trees(degrees, max_degree, min, order());
+  }
 
-    auto min_node_owner = [&]() -> std::unique_ptr<Node>
-    {
-      if (min_node == head.get())
-      {
-        return std::exchange(head, std::move(head->sibling));
-      }
-      return std::exchange(prev_min->sibling, std::move(min_node->sibling));
-    }();
-
-    if (min_node == tail)
-    {
-      tail = prev_min;
-    }
+private:
+  using DegreeTable = root_list::DegreeTable<Node>; ///< Trees indexed by degree.
 
-    --size;
+  [[no_unique_address]] Compare comp;    ///< The comparator used to order the keys.
+  [[no_unique_address]] Projection proj; ///< The projection applied to the keys before they are compared.
+  NodePool<Node, Allocator> nodes;       ///< The pool that the nodes of the heap are allocated from.
+  Node *min;                             ///< A pointer to the root with the minimum key, and into the root list.
+  size_t size;                           ///< The number of nodes in the heap.
 
-    return min_node_owner;
+  /**
+   * @brief Returns whether the key `a` comes before the key `b` in the order of the heap.
+   */
+  constexpr bool less(const T &a, const T &b) const
+  {
+    return std::invoke(comp, std::invoke(proj, a), std::invoke(proj, b));
   }
 
   /**
-   * @brief Links two trees in the heap.
-   *
-   * This method links two binomial trees, resulting in a binomial tree with a higher degree.
-   * The tree with the larger key becomes the child of the tree with the smaller key.
-   * The degree of the parent tree is incremented by 1.
-   *
-   * The time complexity of this operation is O(1), because it only involves updating the
-   * sibling and child pointers of the trees.
-   *
-   * @param tree1 The first tree to link.
-   * @param tree2 The second tree to link.
-   * @return The resulting tree after the link.
+   * @brief Returns the order of the keys of the heap, as passed to the root list operations.
    */
-  constexpr std::unique_ptr<Node> link(std::unique_ptr<Node> tree1, std::unique_ptr<Node> tree2) const
+  constexpr auto order() const noexcept
   {
-    if (tree1->key > tree2->key)
-    {
-      std::swap(tree1, tree2);
-    }
-    tree2->sibling = std::move(tree1->child);
-    tree1->child = std::move(tree2);
-    tree1->degree += 1;
-
-    return tree1;
+    return [this](const T &a, const T &b)
+    { return less(a, b); };
   }
 
   /**
-   * @brief Performs a count sort on the root list.
+   * @brief Destroys every tree in a root list.
    *
-   * This method performs a count sort on the root list based on the degree of the
-   * nodes. It returns a vector of vectors, where each inner vector contains the nodes
-   * with the same degree.
+   * This method breaks the circular root list containing `node` into a null-terminated
+   * list, and destroys every tree in it iteratively, returning their nodes to the node pool.
    *
-   * The time complexity of this operation is O(log n), where n is the number of nodes
-   * in the heap. This is because the nodes are sorted into buckets based on their degree,
-   * which is bounded by the logarithm of the number of nodes in the heap.
+   * The time complexity of this operation is O(k), where k is the number of nodes in the
+   * destroyed trees.
    *
-   * @return A vector of vectors containing the nodes sorted by degree.
+   * @param node Any root in the root list to destroy, or `nullptr`.
    */
-  constexpr auto count_sort()
+  constexpr void destroy(Node *node) noexcept
   {
-    size_t max_degree = std::ceil(std::log2(size)) + 1; // O(1)
-    std::vector<std::vector<std::unique_ptr<Node>>> count(max_degree);
-
-    for (std::unique_ptr<Node> curr = std::move(head); curr != nullptr;)
+    if (node != nullptr)
     {
-      std::unique_ptr<Node> next = std::move(curr->sibling);
-      int degree = curr->degree;
-      count[degree].push_back(std::exchange(curr, std::move(next)));
+      node->prev->sibling = nullptr;
     }
-
-    return count;
+    forest::destroy(node, nodes);
   }
 
   /**
-   * @brief Consolidates the heap.
+   * @brief Removes a root from the heap and returns its key.
    *
-   * This method consolidates the heap to ensure that no two trees have the same
-   * degree. It performs a count sort on the root list, and then links together any
-   * trees with the same degree until all trees have different degrees.
+   * The root is unlinked from the root list, and the remaining roots and its children are
+   * consolidated by `root_list::consolidate`, which also finds the new minimum. Trees of
+   * the same degree are linked until no two trees have the same degree.
    *
-   * The time complexity of this operation is O(log n) in the average case (amortized),
-   * and O(n) in the worst case where n is the number of nodes in the heap. This is
-   * because the heap is consolidated by linking binomial trees of the same degree until
-   * there are no two trees with the same degree; this process involves iterating over
-   * the root list, which is ideally logarithmic in the number of nodes in the heap,
-   * however in the worst case the root list may contain all the nodes in the heap
-   * (for example by merging n heaps of size 1), in which case the time complexity
-   * becomes linear in the number of nodes in the heap.
-   */
-  constexpr void consolidate()
+   * The time complexity of this operation is O(log n) amortized, where n is the number of
+   * nodes in the heap, and O(n) in the worst case, e.g. right after merging n heaps of size
+   * 1, when the root list holds all the nodes of the heap.
+   *
+   * @param root The root to remove.
+   * @return The key of the removed root.
+   */
+  constexpr T remove_root(Node *root)
   {
-    if (head == nullptr)
-    {
-      return;
-    }
-
-    auto count = count_sort(); // O(log n)
+    Node *roots = root_list::unlink(root); // O(1)
+    --size;
 
-    for (size_t i = 0; i < count.size(); ++i)
-    {
-      auto &bucket = count[i];
-      if (bucket.size() <= 1)
-      {
-        continue;
-      }
-      while (bucket.size() > 1) // link trees with the same degree
-      {
-        auto tree1 = std::move(bucket.back());
-        bucket.pop_back();
-        auto tree2 = std::move(bucket.back());
-        bucket.pop_back();
-        count[i + 1].push_back(link(std::move(tree1), std::move(tree2)));
-      }
-    }
+    min = root_list::consolidate(roots, root->child, order()); // O(log n) amortized
 
-    head = nullptr;
-    tail = nullptr;
-    for (size_t i = 0; i < count.size(); ++i) // concatenate the trees back to the root list
-    {
-      if (!count[i].empty())
-      {
-        if (head == nullptr)
-        {
-          head = std::move(count[i].front());
-          tail = head.get();
-        }
-        else
-        {
-          tail->sibling = std::move(count[i].front());
-          tail = tail->sibling.get();
-        }
-      }
-    }
+    T key = std::move(root->key);
+    nodes.destroy(root);
+    return key;
   }
 }; // class LazyBinomialHeap
 
+namespace pmr
+{
+  /**
+   * @brief A `LazyBinomialHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T, typename Compare = std::less<>, typename Projection = std::identity>
+  using LazyBinomialHeap = ::LazyBinomialHeap<T, Compare, Projection, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
 #endif // LAZY_BINOMIAL_HEAP_H
\ No newline at end of file
@@ -0,0 +1,418 @@
+#ifndef LEFTIST_HEAP_H
+#define LEFTIST_HEAP_H
+
+#include "mergeable_heap.h"
+#include "node_pool.h"
+#include "forest.h"
+
+#include <array>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class LeftistHeap
+ *
+ * @brief A mergeable heap with O(log n) worst-case merge and extract_min.
+ *
+ * @details This mergeable heap is implemented using a leftist heap, a heap-ordered binary
+ * tree in which the rank of every left child is at least the rank of its right sibling,
+ * where the rank of a node is the length of its right spine. Hence the right spine of a
+ * tree with n nodes holds at most log2(n + 1) nodes. Two heaps are merged by merging their
+ * right spines like two sorted lists, and then swapping the children of every node on the
+ * merged spine whose ranks violate the leftist property. Insertion and extract_min are
+ * both merges, so every operation takes O(log n) time in the worst case, not just
+ * amortized. This makes the latency of every operation predictable, even after many
+ * merges.
+ *
+ * The nodes of the heap are allocated from a per-heap `NodePool`.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method.
+ * @tparam Allocator The allocator used by the node pool to allocate its slabs.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class LeftistHeap final : public MergeableHeapBase<LeftistHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<LeftistHeap, T>; ///< The non-virtual base of the heap.
+  friend Base;
+
+private:
+  /**
+   * @struct Node
+   * @brief A node in the heap.
+   */
+  struct Node
+  {
+    T key;       ///< The key stored in the node.
+    int rank;    ///< The number of nodes on the right spine of the node's subtree.
+    Node *left;  ///< A pointer to the node's left child.
+    Node *right; ///< A pointer to the node's right child.
+
+    /**
+     * @brief Constructs a new leaf whose key is constructed in place from the given arguments.
+     *
+     * @param args The arguments forwarded to the constructor of the key.
+     */
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) : key(std::forward<Args>(args)...), rank(1), left(nullptr), right(nullptr) {}
+  };
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr LeftistHeap() : LeftistHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit LeftistHeap(const Allocator &alloc) noexcept : nodes(alloc), root(nullptr) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr LeftistHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : LeftistHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr LeftistHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return LeftistHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The nodes are destroyed iteratively, so destroying a heap with a long left spine does
+   * not overflow the stack.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, or O(s) if `T` is trivially destructible, where s is the number of slabs.
+   */
+  constexpr ~LeftistHeap()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The new node is merged with the root.
+   *
+   * The time complexity of this operation is O(log n) in the worst case.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    root = meld(root, nodes.create(std::in_place, std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The time complexity of this operation is O(1) if `T` is trivially destructible, and
+   * O(n) otherwise, where n is the number of nodes in the heap.
+   */
+  constexpr void clear() noexcept
+  {
+    if consteval
+    {
+      forest::destroy(root, nodes, &Node::left, &Node::right);
+    }
+    else
+    {
+      if constexpr (std::is_trivially_destructible_v<Node>)
+      {
+        nodes.release();
+      }
+      else
+      {
+        forest::destroy(root, nodes, &Node::left, &Node::right);
+      }
+    }
+
+    root = nullptr;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is stored in
+   * the root.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (root == nullptr)
+    {
+      return std::nullopt;
+    }
+    return std::cref(root->key);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The root is removed, and its two subtrees are merged into the new root.
+   *
+   * The time complexity of this operation is O(log n) in the worst case.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    Node *min_node = root;
+    if (min_node == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    root = meld(min_node->left, min_node->right);
+
+    T key = std::move(min_node->key);
+    nodes.destroy(min_node);
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The trees of both heaps are merged along their right spines, and the node pool of the
+   * other heap is spliced into the node pool of this heap.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the slabs of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
+   * The time complexity of this operation is O(log n + log m) in the worst case, where n
+   * and m are the number of nodes in the two heaps.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(LeftistHeap &other)
+  {
+    root = meld(root, other.root);
+    nodes.splice(other.nodes);
+
+    other.root = nullptr;
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys of the nodes in the heap using a breadth-first traversal
+   * starting from the root.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
+   */
+  void print() const
+  {
+    if (root == nullptr)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    std::queue<Node *> q;
+    q.push(root);
+    while (!q.empty())
+    {
+      Node *curr = q.front();
+      q.pop();
+      std::cout << curr->key << ", ";
+      for (Node *child : {curr->left, curr->right})
+      {
+        if (child != nullptr)
+        {
+          q.push(child);
+        }
+      }
+    }
+
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n log n), where n is the number of nodes
+   * in the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(LeftistHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return nodes.get_allocator();
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The keys are built into a leftist heap of their own by merging the trees in pairs,
+   * round after round, until a single tree is left, which is then merged with the root.
+   *
+   * The time complexity of this operation is O(k + log n), where k is the number of keys
+   * in the batch, since merging k / 2^i pairs of trees of size 2^i takes O(k i / 2^i)
+   * time in round i.
+   *
+   * @param keys The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> keys)
+  {
+    if (keys.empty())
+    {
+      return;
+    }
+
+    using TreeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node *>;
+    std::vector<Node *, TreeAllocator> trees(TreeAllocator(this->get_allocator()));
+    trees.reserve(keys.size());
+    for (T &key : keys)
+    {
+      trees.push_back(nodes.create(std::in_place, std::move(key)));
+    }
+
+    for (std::size_t count = trees.size(); count > 1; count = (count + 1) / 2)
+    {
+      for (std::size_t i = 0; i < count / 2; ++i)
+      {
+        trees[i] = meld(trees[2 * i], trees[2 * i + 1]);
+      }
+      if (count % 2 == 1)
+      {
+        trees[count / 2] = trees[count - 1];
+      }
+    }
+
+    root = meld(root, trees[0]);
+  }
+
+private:
+  NodePool<Node, Allocator> nodes; ///< The pool that the nodes of the heap are allocated from.
+  Node *root;                      ///< A pointer to the root of the tree, which holds the minimum key.
+
+  /**
+   * @brief Returns the rank of a tree, where the empty tree has rank 0.
+   */
+  static constexpr int rank(const Node *tree) noexcept
+  {
+    return tree == nullptr ? 0 : tree->rank;
+  }
+
+  /**
+   * @brief Merges two trees.
+   *
+   * The right spines of both trees are merged like two sorted lists, remembering the
+   * nodes of the merged spine. Then the spine is walked bottom-up, swapping the children
+   * of every node whose left child has a smaller rank than its right child, and updating
+   * the ranks. Both walks are iterative; the spine is remembered in a table on the stack,
+   * which is always large enough, since each right spine holds at most log2(n + 1) nodes.
+   *
+   * The time complexity of this operation is O(log n + log m), where n and m are the
+   * number of nodes in the two trees.
+   *
+   * @param tree1 The first tree to merge, or `nullptr`.
+   * @param tree2 The second tree to merge, or `nullptr`.
+   * @return The root of the merged tree, or `nullptr` if both trees are empty.
+   */
+  static constexpr Node *meld(Node *tree1, Node *tree2) noexcept
+  {
+    std::array<Node *, 2 * std::numeric_limits<size_t>::digits> spine;
+    std::size_t length = 0;
+
+    Node *result = nullptr;
+    Node **link = &result;
+    while (tree1 != nullptr && tree2 != nullptr)
+    {
+      if (tree2->key < tree1->key)
+      {
+        std::swap(tree1, tree2);
+      }
+      *link = tree1;
+      spine[length++] = tree1;
+      link = &tree1->right;
+      tree1 = tree1->right;
+    }
+    *link = tree1 != nullptr ? tree1 : tree2;
+
+    while (length > 0)
+    {
+      Node *node = spine[--length];
+      if (rank(node->left) < rank(node->right))
+      {
+        std::swap(node->left, node->right);
+      }
+      node->rank = rank(node->right) + 1;
+    }
+    return result;
+  }
+}; // class LeftistHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `LeftistHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T>
+  using LeftistHeap = ::LeftistHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // LEFTIST_HEAP_H
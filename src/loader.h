@@ -0,0 +1,199 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define MMAP_AVAILABLE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MMAP_AVAILABLE 0
+#include <fstream>
+#include <iterator>
+#endif
+
+/**
+ * @class MappedFile
+ *
+ * @brief A read-only view of the contents of a whole file.
+ *
+ * @details On POSIX systems the file is memory-mapped, so its contents are paged in by the
+ * kernel on demand instead of being copied through stream buffers. On other systems the file
+ * is read into memory at once. Just like `std::ifstream`, a file that cannot be opened does
+ * not throw; check `is_open()` instead.
+ */
+class MappedFile
+{
+public:
+  /**
+   * @brief Opens and maps the file at the given path.
+   *
+   * @param path The path of the file to map.
+   */
+  explicit MappedFile(const std::string &path)
+  {
+#if MMAP_AVAILABLE
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+      size = static_cast<std::size_t>(info.st_size);
+      if (size == 0)
+      {
+        opened = true; // an empty file cannot be mapped, but it is still a file
+      }
+      else if (void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); mapped != MAP_FAILED)
+      {
+        ::madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapped);
+        opened = true;
+      }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (file.is_open())
+    {
+      buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      data = buffer.data();
+      size = buffer.size();
+      opened = true;
+    }
+#endif
+  }
+
+  /**
+   * @brief Unmaps the file.
+   */
+  ~MappedFile()
+  {
+#if MMAP_AVAILABLE
+    if (data != nullptr)
+    {
+      ::munmap(const_cast<char *>(data), size);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief Returns whether the file was opened successfully.
+   */
+  bool is_open() const noexcept
+  {
+    return opened;
+  }
+
+  /**
+   * @brief Returns the contents of the file.
+   */
+  std::string_view view() const noexcept
+  {
+    return {data, size};
+  }
+
+private:
+  const char *data = nullptr; ///< The contents of the file.
+  std::size_t size = 0;       ///< The size of the file in bytes.
+  bool opened = false;        ///< Whether the file was opened successfully.
+#if !MMAP_AVAILABLE
+  std::string buffer; ///< The contents of the file, if it could not be mapped.
+#endif
+};
+
+/**
+ * @brief Splits the next line off the front of a text.
+ *
+ * The end of the line is found with `std::memchr`, which the C library implements with
+ * vector instructions. Like `std::getline`, the last line does not need to end with a
+ * newline, and no line is returned once the text is exhausted.
+ *
+ * @param text The remaining text; the returned line and its newline are removed from it.
+ * @return The next line without its newline, or `std::nullopt` if the text is empty.
+ */
+inline std::optional<std::string_view> next_line(std::string_view &text) noexcept
+{
+  if (text.empty())
+  {
+    return std::nullopt;
+  }
+
+  const void *newline = std::memchr(text.data(), '\n', text.size());
+  const std::size_t length = newline != nullptr ? static_cast<const char *>(newline) - text.data() : text.size();
+  std::string_view line = text.substr(0, length);
+  text.remove_prefix(std::min(length + 1, text.size()));
+  return line;
+}
+
+/**
+ * @brief Parses the whitespace-separated integers of a line.
+ *
+ * The integers are parsed in place with `std::from_chars`, so no string is allocated per
+ * token. Blanks (spaces, tabs and carriage returns) are skipped, and a leading plus sign
+ * is accepted if a digit follows it.
+ *
+ * @param line The line to parse.
+ * @return The integers in the line, in order.
+ * @throws std::runtime_error If a token is not an integer, or does not fit in an `int`.
+ */
+inline std::vector<int> parse_integers(std::string_view line)
+{
+  auto is_blank = [](char c)
+  { return c == ' ' || c == '\t' || c == '\r'; };
+
+  std::vector<int> values;
+  values.reserve(line.size() / 4);
+
+  const char *curr = line.data();
+  const char *const end = curr + line.size();
+  while (true)
+  {
+    while (curr != end && is_blank(*curr))
+    {
+      ++curr;
+    }
+    if (curr == end)
+    {
+      return values;
+    }
+
+    const char *token = curr;
+    if (*curr == '+' && curr + 1 != end && *(curr + 1) >= '0' && *(curr + 1) <= '9')
+    {
+      ++curr; // from_chars rejects the plus sign, so anything else after it is rejected too
+    }
+    int value;
+    auto [next, error] = std::from_chars(curr, end, value);
+    if (error != std::errc{} || (next != end && !is_blank(*next)))
+    {
+      const char *token_end = token;
+      while (token_end != end && !is_blank(*token_end))
+      {
+        ++token_end;
+      }
+      throw std::runtime_error("\"" + std::string(token, token_end) + "\" is not a number I can count to!");
+    }
+    values.push_back(value);
+    curr = next;
+  }
+}
+
+#undef MMAP_AVAILABLE // not leaked to the files including the loader
+
+#endif // LOADER_H
@@ -1,13 +1,71 @@
 #ifndef MERGEABLE_HEAP_H
 #define MERGEABLE_HEAP_H
 
+#include <concepts>
+#include <functional>
 #include <optional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The operations of a mergeable heap, checked at compile time.
+ *
+ * @details A type models `mergeable_heap` if it supports MINIMUM, INSERT, EXTRACT-MIN and
+ * UNION with the signatures of `MergeableHeap`. Generic code constrained on this concept
+ * calls the concrete heap directly, so every operation can be inlined. The concrete heaps
+ * all model it through `MergeableHeapBase`, and so do `MergeableHeap` and `PolymorphicHeap`.
+ */
+template <typename H>
+concept mergeable_heap = requires(H &heap, const H &const_heap, typename H::value_type key) {
+  heap.insert(std::move(key));
+  { const_heap.minimum() } -> std::same_as<std::optional<std::reference_wrapper<const typename H::value_type>>>;
+  { heap.extract_min() } -> std::same_as<std::optional<typename H::value_type>>;
+  heap.merge(heap);
+};
+
+/**
+ * @brief The buffering shared by the `insert_range` functions of the heaps.
+ */
+namespace bulk
+{
+  /**
+   * @brief Collects the keys in the range [first, last) into a buffer.
+   *
+   * The buffer reserves room for all keys at once when the size of the range is known.
+   *
+   * @param allocator The allocator of the buffer.
+   * @param first The first key in the range.
+   * @param last The end of the range.
+   * @return The buffer holding the keys.
+   */
+  template <typename Allocator, std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr auto collect(const Allocator &allocator, Iterator first, Sentinel last)
+  {
+    std::vector<typename std::allocator_traits<Allocator>::value_type, Allocator> keys(allocator);
+    if constexpr (std::sized_sentinel_for<Sentinel, Iterator>)
+    {
+      keys.reserve(static_cast<size_t>(last - first));
+    }
+    for (; first != last; ++first)
+    {
+      keys.emplace_back(*first);
+    }
+    return keys;
+  }
+} // namespace bulk
 
 /**
  * @class MergeableHeap
  *
- * @brief A constexpr-friendly interface for a mergeable heap data structure.
+ * @brief A constexpr-friendly runtime-polymorphic interface for a mergeable heap data
+ * structure.
  *
  * @details A mergeable heap is a type of heap that supports the following operations:
  * 1. MAKE-HEAP creates a new (empty) heap.
@@ -16,13 +74,28 @@
  * 4. EXTRACT-MIN removes and returns the element with the minimum key in the heap.
  * 5. UNION merges two heaps into a single heap.
  *
+ * The order of the keys is given by `Compare` applied to the keys projected by
+ * `Projection`, so the "minimum" is the key that no other key compares less than; a
+ * `std::greater<>` comparator turns the heap into a max-heap. Only heaps with the same
+ * ordering can be merged with each other.
+ *
+ * The concrete heaps do not derive from this interface, so their operations are not
+ * virtual. A concrete heap is used through this interface by wrapping it in a
+ * `PolymorphicHeap`, e.g. when the heap is chosen at runtime.
+ *
  * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
  * moved into the heap in the insert method.
+ * @tparam Compare The strict weak ordering of the projected keys.
+ * @tparam Projection The projection applied to the keys before they are compared.
  */
-template <typename T>
+template <typename T, typename Compare = std::less<>, typename Projection = std::identity>
 class MergeableHeap
 {
 public:
+  using value_type = T;              ///< The type of the elements stored in the heap.
+  using key_compare = Compare;       ///< The strict weak ordering of the projected keys.
+  using key_projection = Projection; ///< The projection applied to the keys before they are compared.
+
   /**
    * Constructs a new empty heap.
    */
@@ -48,6 +121,43 @@ public:
    */
   constexpr virtual void insert(T key) = 0;
 
+  /**
+   * @brief Inserts all keys in the range [first, last) into the heap.
+   *
+   * The keys are collected into a temporary buffer, which is handed over to the
+   * `insert_bulk` hook of the derived class. Outside of constant evaluation, the buffer is
+   * allocated from the memory resource returned by `bulk_resource`. Use
+   * `std::make_move_iterator` to move the keys out of the range instead of copying them.
+   *
+   * Complexity depends on the implementation of the heap, and is at most
+   * O(k) * O(insert), where k is the number of inserted keys.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+    requires std::constructible_from<T, std::iter_reference_t<Iterator>>
+  constexpr void insert_range(Iterator first, Sentinel last)
+  {
+    if consteval
+    {
+      auto keys = bulk::collect(std::allocator<T>(), std::move(first), std::move(last));
+      insert_bulk(keys);
+    }
+    else
+    {
+      auto keys = bulk::collect(std::pmr::polymorphic_allocator<T>(bulk_resource()), std::move(first), std::move(last));
+      insert_bulk(keys);
+    }
+  }
+
+  /**
+   * @brief Inserts all keys in the range into the heap.
+   */
+  template <std::ranges::input_range Range>
+    requires std::constructible_from<T, std::ranges::range_reference_t<Range>>
+  constexpr void insert_range(Range &&range)
+  {
+    insert_range(std::ranges::begin(range), std::ranges::end(range));
+  }
+
   /**
    * Returns the minimum key in the heap.
    */
@@ -61,7 +171,7 @@ public:
   /**
    * Merges another heap into this heap.
    */
-  constexpr virtual void merge(MergeableHeap<T> &other) = 0;
+  constexpr virtual void merge(MergeableHeap &other) = 0;
 
   /**
    * Prints the heap.
@@ -81,13 +191,41 @@ public:
   virtual void sort() = 0;
 
 protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * This hook is called by `insert_range`. The keys are moved out of the span, which the
+   * implementation may also reorder. The default implementation inserts the keys one by
+   * one; derived classes override it when a batch can be inserted faster as a whole.
+   */
+  constexpr virtual void insert_bulk(std::span<T> keys)
+  {
+    for (T &key : keys)
+    {
+      insert(std::move(key));
+    }
+  }
+
+  /**
+   * @brief Returns the memory resource that `insert_range` allocates its buffer from.
+   *
+   * The default implementation returns the default memory resource. Implementations that
+   * allocate from a memory resource of their own return it, so that a bulk insertion does
+   * not touch the global heap.
+   */
+  virtual std::pmr::memory_resource *bulk_resource() const noexcept
+  {
+    return std::pmr::get_default_resource();
+  }
+
   /**
    * @brief Sorts the heap using a temporary heap.
    *
    * This function should be called by the `sort` function of the derived class
-   * in the following way: `this->MergeableHeap<T>::sort(DerivedHeap<T>{})`.
+   * in the following way: `this->MergeableHeap<T>::sort(DerivedHeap<T>{})`. The
+   * temporary heap must have the same ordering as this heap.
    */
-  void sort(MergeableHeap<T> &&temp)
+  void sort(MergeableHeap &&temp)
   {
     while (auto key = extract_min())
     {
@@ -97,4 +235,284 @@ protected:
   }
 };
 
-#endif // MERGEABLE_HEAP_H
\ No newline at end of file
+template <mergeable_heap H, typename Interface>
+class PolymorphicHeap;
+
+/**
+ * @class MergeableHeapBase
+ *
+ * @brief The non-virtual base of the concrete mergeable heaps.
+ *
+ * @details The concrete heaps derive from this base with the curiously recurring template
+ * pattern, and implement INSERT, MINIMUM, EXTRACT-MIN and UNION as plain member functions.
+ * The base provides the operations shared by all heaps, i.e. `insert_range` and the sort
+ * helper, on top of them. Since no call goes through a virtual table, calls on a concrete
+ * heap can be inlined, and the heaps do not carry a virtual table pointer.
+ *
+ * A derived class that inserts batches faster than one key at a time hides the
+ * `insert_bulk` hook, and makes the base a friend so that the base can call it.
+ *
+ * @tparam Derived The concrete heap deriving from this base.
+ * @tparam T The type of the elements stored in the heap.
+ * @tparam Compare The strict weak ordering of the projected keys.
+ * @tparam Projection The projection applied to the keys before they are compared.
+ */
+template <typename Derived, typename T, typename Compare = std::less<>, typename Projection = std::identity>
+class MergeableHeapBase
+{
+public:
+  using value_type = T;              ///< The type of the elements stored in the heap.
+  using key_compare = Compare;       ///< The strict weak ordering of the projected keys.
+  using key_projection = Projection; ///< The projection applied to the keys before they are compared.
+
+  /**
+   * @brief Deleted and defaulted special member functions.
+   *
+   * Heaps should not be copied. They may be moved, if the derived class defines how.
+   */
+  constexpr MergeableHeapBase(const MergeableHeapBase &) = delete;
+  constexpr MergeableHeapBase &operator=(const MergeableHeapBase &) = delete;
+  constexpr MergeableHeapBase(MergeableHeapBase &&) noexcept = default;
+  constexpr MergeableHeapBase &operator=(MergeableHeapBase &&) noexcept = default;
+
+  /**
+   * @brief Inserts all keys in the range [first, last) into the heap.
+   *
+   * The keys are collected into a temporary buffer, which is handed over to the
+   * `insert_bulk` hook of the derived class. The buffer uses the allocator of the heap,
+   * rebound to `T`, so the keys of a `pmr` heap are buffered in its memory resource. Use
+   * `std::make_move_iterator` to move the keys out of the range instead of copying them.
+   *
+   * Complexity depends on the implementation of the heap, and is at most
+   * O(k) * O(insert), where k is the number of inserted keys.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+    requires std::constructible_from<T, std::iter_reference_t<Iterator>>
+  constexpr void insert_range(Iterator first, Sentinel last)
+  {
+    using KeyAllocator = typename std::allocator_traits<typename Derived::allocator_type>::template rebind_alloc<T>;
+    auto keys = bulk::collect(KeyAllocator(derived().get_allocator()), std::move(first), std::move(last));
+    derived().insert_bulk(keys);
+  }
+
+  /**
+   * @brief Inserts all keys in the range into the heap.
+   */
+  template <std::ranges::input_range Range>
+    requires std::constructible_from<T, std::ranges::range_reference_t<Range>>
+  constexpr void insert_range(Range &&range)
+  {
+    insert_range(std::ranges::begin(range), std::ranges::end(range));
+  }
+
+protected:
+  /**
+   * Constructs a new empty heap.
+   */
+  constexpr MergeableHeapBase() = default;
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The destructor is protected and not virtual, as heaps are never destroyed through
+   * their base.
+   */
+  constexpr ~MergeableHeapBase() = default;
+
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * This hook is called by `insert_range`. The keys are moved out of the span, which the
+   * implementation may also reorder. The default implementation inserts the keys one by
+   * one; derived classes hide it when a batch can be inserted faster as a whole.
+   */
+  constexpr void insert_bulk(std::span<T> keys)
+  {
+    for (T &key : keys)
+    {
+      derived().insert(std::move(key));
+    }
+  }
+
+  /**
+   * @brief Sorts the heap using a temporary heap.
+   *
+   * This function should be called by the `sort` function of the derived class
+   * in the following way: `this->Base::sort(DerivedHeap<T>{})`, where `Base` is this
+   * base. The temporary heap must have the same ordering as this heap.
+   */
+  void sort(Derived &&temp)
+  {
+    while (auto key = derived().extract_min())
+    {
+      temp.insert(std::move(*key));
+    }
+    derived().merge(temp);
+  }
+
+private:
+  template <mergeable_heap H, typename Interface>
+  friend class PolymorphicHeap;
+
+  /**
+   * @brief Returns this heap as its derived class.
+   */
+  constexpr Derived &derived() noexcept
+  {
+    return static_cast<Derived &>(*this);
+  }
+
+  /**
+   * @brief Hands a batch of keys to the `insert_bulk` hook of the derived class.
+   *
+   * `PolymorphicHeap` forwards the batch it collected through this function, so the keys
+   * are not copied into a second buffer by `insert_range`.
+   */
+  constexpr void forward_bulk(std::span<T> keys)
+  {
+    derived().insert_bulk(keys);
+  }
+};
+
+/**
+ * @class PolymorphicHeap
+ *
+ * @brief A type-erased adapter that exposes a concrete heap through the `MergeableHeap`
+ * interface.
+ *
+ * @details The adapter owns a heap of type `H`, and forwards every virtual operation of
+ * the interface to it. Code that only knows the interface pays one indirect call per
+ * operation, while code that knows `H` keeps calling it directly through `get()`.
+ *
+ * Two adapters can only be merged if they wrap heaps of the same type; merging adapters
+ * of different types throws `std::bad_cast`.
+ *
+ * @tparam H The type of the wrapped heap.
+ * @tparam Interface The interface implemented by the adapter. Adapters for interfaces that
+ * extend `MergeableHeap`, such as `DoubleEndedMergeableHeap`, derive from this class and
+ * implement the additional operations.
+ */
+template <mergeable_heap H, typename Interface = MergeableHeap<typename H::value_type, typename H::key_compare, typename H::key_projection>>
+class PolymorphicHeap : public Interface
+{
+private:
+  using T = typename H::value_type;
+
+public:
+  /**
+   * @brief Constructs the wrapped heap from the given arguments.
+   *
+   * The time complexity of this operation is the time complexity of the constructor of `H`.
+   */
+  template <typename... Args>
+    requires std::constructible_from<H, Args...>
+  constexpr explicit PolymorphicHeap(Args &&...args) : heap(std::forward<Args>(args)...) {}
+
+  /**
+   * @brief Inserts a key into the wrapped heap.
+   */
+  constexpr void insert(T key) override
+  {
+    heap.insert(std::move(key));
+  }
+
+  /**
+   * @brief Returns the minimum key in the wrapped heap.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const override
+  {
+    return heap.minimum();
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the wrapped heap.
+   */
+  constexpr std::optional<T> extract_min() override
+  {
+    return heap.extract_min();
+  }
+
+  /**
+   * @brief Merges the heap wrapped by another adapter into the wrapped heap.
+   *
+   * @throws std::bad_cast If the other heap is not a `PolymorphicHeap` wrapping a heap of
+   * type `H`.
+   */
+  constexpr void merge(MergeableHeap<T, typename H::key_compare, typename H::key_projection> &other) override
+  {
+    heap.merge(dynamic_cast<PolymorphicHeap &>(other).heap);
+  }
+
+  /**
+   * @brief Prints the wrapped heap.
+   */
+  void print() const override
+  {
+    heap.print();
+  }
+
+  /**
+   * @brief Sorts the wrapped heap in ascending order.
+   */
+  void sort() override
+  {
+    heap.sort();
+  }
+
+  /**
+   * @brief Returns the wrapped heap.
+   */
+  constexpr H &get() noexcept
+  {
+    return heap;
+  }
+
+  /**
+   * @brief Returns the wrapped heap.
+   */
+  constexpr const H &get() const noexcept
+  {
+    return heap;
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the wrapped heap.
+   *
+   * The batch is handed to the `insert_bulk` hook of the wrapped heap as is. A heap that
+   * does not derive from `MergeableHeapBase` gets the keys moved into its `insert_range`.
+   */
+  constexpr void insert_bulk(std::span<T> keys) override
+  {
+    if constexpr (requires { heap.forward_bulk(keys); })
+    {
+      heap.forward_bulk(keys);
+    }
+    else
+    {
+      heap.insert_range(std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.end()));
+    }
+  }
+
+  /**
+   * @brief Returns the memory resource of the wrapped heap, if it allocates from one.
+   *
+   * The wrapped heap allocates from a memory resource if its allocator is a
+   * `std::pmr::polymorphic_allocator`; otherwise, the default memory resource is returned.
+   */
+  std::pmr::memory_resource *bulk_resource() const noexcept override
+  {
+    if constexpr (requires { { heap.get_allocator().resource() } -> std::convertible_to<std::pmr::memory_resource *>; })
+    {
+      return heap.get_allocator().resource();
+    }
+    else
+    {
+      return std::pmr::get_default_resource();
+    }
+  }
+
+  H heap; ///< The wrapped heap.
+};
+
+#endif // MERGEABLE_HEAP_H
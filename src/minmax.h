@@ -0,0 +1,496 @@
+#ifndef MIN_MAX_HEAP_H
+#define MIN_MAX_HEAP_H
+
+#include "double_ended_heap.h"
+
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class MinMaxHeap
+ *
+ * @brief A double-ended mergeable heap implemented as an implicit min-max heap.
+ *
+ * @details A min-max heap is a complete binary tree stored in level order in an array,
+ * like a binary heap, whose levels alternate between min levels and max levels, starting
+ * with a min level at the root. Every key on a min level is not greater than any key in its
+ * subtree, and every key on a max level is not smaller than any key in its subtree. Hence
+ * the minimum is the root, and the maximum is the larger of the root's children.
+ *
+ * A key is inserted by sifting it up along either the min levels or the max levels of its
+ * path, and a key is removed by sifting the last key down from its slot, comparing its
+ * children and grandchildren. Both take O(log n) time. Like a binary heap, a min-max heap
+ * can be built bottom-up in linear time, which is used for merging and bulk insertion.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method, and swappable, as keys are swapped along the
+ * heap.
+ * @tparam Allocator The allocator used to allocate the array.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class MinMaxHeap final : public MergeableHeapBase<MinMaxHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<MinMaxHeap, T>; ///< The non-virtual base of the heap.
+  friend Base;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr MinMaxHeap() : MinMaxHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its array using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the array.
+   */
+  constexpr explicit MinMaxHeap(const Allocator &alloc) noexcept : keys(alloc) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the array.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr MinMaxHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : MinMaxHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr MinMaxHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return MinMaxHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr ~MinMaxHeap() = default;
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The key is appended to the array and sifted up along the min levels or the max levels
+   * of its path.
+   *
+   * The time complexity of this operation is O(log n) amortized, where n is the number of
+   * keys in the heap.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly in its slot of the array.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    keys.emplace_back(std::forward<Args>(args)...);
+    sift_up(keys.size() - 1);
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is the root.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (keys.empty())
+    {
+      return std::nullopt;
+    }
+    return std::cref(keys[0]);
+  }
+
+  /**
+   * @brief Returns the maximum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the maximum key is the root or
+   * one of its children.
+   *
+   * @return A reference to the maximum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> maximum() const noexcept
+  {
+    if (keys.empty())
+    {
+      return std::nullopt;
+    }
+    return std::cref(keys[max_index()]);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(log n), where n is the number of keys in
+   * the heap.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (keys.empty())
+    {
+      return std::nullopt;
+    }
+    return remove(0);
+  }
+
+  /**
+   * @brief Removes and returns the maximum key in the heap.
+   *
+   * The time complexity of this operation is O(log n), where n is the number of keys in
+   * the heap.
+   *
+   * @return The maximum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_max()
+  {
+    if (keys.empty())
+    {
+      return std::nullopt;
+    }
+    return remove(max_index());
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The arrays are swapped if the other heap holds more keys, so the smaller array is
+   * always the one being copied. Its keys are then appended, see `append`.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the arrays may be swapped.
+   *
+   * The time complexity of this operation is O(min(n + m, m log n)), where m is the
+   * number of keys in the smaller heap and n is the number of keys in the larger heap.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(MinMaxHeap &other)
+  {
+    if (other.keys.size() > keys.size())
+    {
+      keys.swap(other.keys);
+    }
+    if (other.keys.empty())
+    {
+      return;
+    }
+
+    append(other.keys.begin(), other.keys.end());
+    other.keys.clear();
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys in the order they are stored in the array, i.e. in level
+   * order.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  void print() const
+  {
+    if (keys.empty())
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for (const T &key : keys)
+    {
+      std::cout << key << ", ";
+    }
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n log n), where n is the number of keys in
+   * the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(MinMaxHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return keys.get_allocator();
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The keys are appended to the array, see `append`.
+   *
+   * The time complexity of this operation is O(min(n + k, k log n)), where n is the number
+   * of keys in the heap and k is the number of keys in the batch.
+   *
+   * @param batch The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> batch)
+  {
+    append(batch.begin(), batch.end());
+  }
+
+private:
+  std::vector<T, Allocator> keys; ///< The keys of the heap, in level order.
+
+  /**
+   * @brief Returns whether the given index lies on a min level.
+   */
+  static constexpr bool on_min_level(std::size_t index) noexcept
+  {
+    return std::bit_width(index + 1) % 2 == 1;
+  }
+
+  /**
+   * @brief Returns whether `a` should be above `b` on the given kind of level.
+   */
+  static constexpr bool before(const T &a, const T &b, bool min_level)
+  {
+    return min_level ? a < b : b < a;
+  }
+
+  /**
+   * @brief Returns the index of the maximum key.
+   *
+   * @pre The heap is not empty.
+   */
+  constexpr std::size_t max_index() const noexcept
+  {
+    if (keys.size() == 1)
+    {
+      return 0;
+    }
+    if (keys.size() == 2 || !(keys[1] < keys[2]))
+    {
+      return 1;
+    }
+    return 2;
+  }
+
+  /**
+   * @brief Removes the key at the given index and returns it.
+   *
+   * The last key is moved into the slot, and sifted down from there.
+   *
+   * The time complexity of this operation is O(log n).
+   *
+   * @param index The index of the key to remove; either the root or one of its children.
+   * @return The removed key.
+   */
+  constexpr T remove(std::size_t index)
+  {
+    T key = std::move(keys[index]);
+    if (index + 1 < keys.size())
+    {
+      keys[index] = std::move(keys.back());
+      keys.pop_back();
+      sift_down(index);
+    }
+    else
+    {
+      keys.pop_back();
+    }
+    return key;
+  }
+
+  /**
+   * @brief Moves the key at the given index up to its place.
+   *
+   * If the key belongs on the other kind of level than its own, it is first swapped with
+   * its parent. Then it is moved up along the levels of its kind, i.e. by grandparents.
+   *
+   * The time complexity of this operation is O(log n).
+   *
+   * @param index The index of the key to sift up.
+   */
+  constexpr void sift_up(std::size_t index)
+  {
+    if (index == 0)
+    {
+      return;
+    }
+
+    bool min_level = on_min_level(index);
+    std::size_t parent = (index - 1) / 2;
+    if (before(keys[parent], keys[index], min_level))
+    {
+      std::swap(keys[index], keys[parent]);
+      index = parent;
+      min_level = !min_level;
+    }
+
+    while (index > 2)
+    {
+      std::size_t grandparent = ((index - 1) / 2 - 1) / 2;
+      if (!before(keys[index], keys[grandparent], min_level))
+      {
+        break;
+      }
+      std::swap(keys[index], keys[grandparent]);
+      index = grandparent;
+    }
+  }
+
+  /**
+   * @brief Moves the key at the given index down to its place.
+   *
+   * At every step the key is compared with the best of its children and grandchildren,
+   * i.e. the smallest on a min level or the largest on a max level. If that is a
+   * grandchild, the keys are swapped and the key may need to swap with its new parent,
+   * which lies on the other kind of level, before moving on. If it is a child, the keys
+   * are swapped and the sift ends.
+   *
+   * The time complexity of this operation is O(log n).
+   *
+   * @param index The index of the key to sift down.
+   */
+  constexpr void sift_down(std::size_t index)
+  {
+    const bool min_level = on_min_level(index);
+    const std::size_t size = keys.size();
+    while (true)
+    {
+      const std::size_t first_child = 2 * index + 1;
+      if (first_child >= size)
+      {
+        return;
+      }
+
+      std::size_t best = first_child;
+      for (std::size_t i : {first_child + 1, 2 * first_child + 1, 2 * first_child + 2, 2 * first_child + 3, 2 * first_child + 4})
+      {
+        if (i < size && before(keys[i], keys[best], min_level))
+        {
+          best = i;
+        }
+      }
+
+      if (!before(keys[best], keys[index], min_level))
+      {
+        return;
+      }
+      std::swap(keys[best], keys[index]);
+      if (best <= first_child + 1) // a child
+      {
+        return;
+      }
+
+      std::size_t parent = (best - 1) / 2;
+      if (before(keys[parent], keys[best], min_level))
+      {
+        std::swap(keys[best], keys[parent]);
+      }
+      index = best;
+    }
+  }
+
+  /**
+   * @brief Moves a range of keys to the end of the array, and restores the heap property.
+   *
+   * A few keys are sifted up one by one, whereas many keys are handled by rebuilding the
+   * whole array bottom-up, whichever takes fewer steps.
+   *
+   * The time complexity of this operation is O(min(n + k, k log n)), where n is the number
+   * of keys in the heap and k is the number of appended keys.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   */
+  template <typename Iterator>
+  constexpr void append(Iterator first, Iterator last)
+  {
+    const std::size_t size = keys.size();
+    keys.insert(keys.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+    const std::size_t count = keys.size() - size;
+    if (count * static_cast<std::size_t>(std::bit_width(keys.size())) < keys.size())
+    {
+      for (std::size_t index = size; index < keys.size(); ++index)
+      {
+        sift_up(index);
+      }
+    }
+    else
+    {
+      heapify();
+    }
+  }
+
+  /**
+   * @brief Restores the min-max heap property of the whole array, bottom-up.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap.
+   */
+  constexpr void heapify()
+  {
+    for (std::size_t index = keys.size() / 2; index-- > 0;)
+    {
+      sift_down(index);
+    }
+  }
+}; // class MinMaxHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `MinMaxHeap` that allocates its array from a `std::pmr::memory_resource`.
+   */
+  template <typename T>
+  using MinMaxHeap = ::MinMaxHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // MIN_MAX_HEAP_H
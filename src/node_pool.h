@@ -0,0 +1,422 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * @class NodePool
+ *
+ * @brief A constexpr-friendly slab allocator for the nodes of a single heap.
+ *
+ * @details The pool carves nodes out of slabs, which are large blocks of memory that are
+ * allocated at once. Freed nodes are pushed onto an intrusive free list, i.e. the link to
+ * the next free slot is stored inside the freed slot itself, and are recycled by later
+ * allocations before any new memory is requested. The capacity of the slabs grows
+ * geometrically, so a small heap wastes little memory while a large heap performs only a
+ * logarithmic number of allocations.
+ *
+ * During constant evaluation the pool falls back to allocating every node on its own,
+ * as memory obtained at compile time cannot be reinterpreted as a free list.
+ *
+ * @tparam Node The type of the nodes stored in the pool.
+ * @tparam Allocator The allocator used to allocate the slabs. It is rebound to the slot
+ * type of the pool.
+ */
+template <typename Node, typename Allocator = std::allocator<Node>>
+class NodePool
+{
+private:
+  /**
+   * @brief Storage for a single node, or a link to the next free slot.
+   */
+  union alignas(Node) Slot
+  {
+    Slot *next;                      ///< The next slot in the free list.
+    std::byte storage[sizeof(Node)]; ///< Raw storage for a node.
+  };
+
+  /**
+   * @brief The header of a slab, stored in the first slots of the slab itself.
+   */
+  struct Slab
+  {
+    Slab *next;           ///< The next slab owned by the pool.
+    std::size_t capacity; ///< The number of node slots in the slab.
+  };
+
+  using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+  using SlotTraits = std::allocator_traits<SlotAllocator>;
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  static constexpr std::size_t header_slots = (sizeof(Slab) + sizeof(Slot) - 1) / sizeof(Slot);
+  static constexpr std::size_t min_capacity = 8;
+  static constexpr std::size_t max_capacity = std::max<std::size_t>(min_capacity, (std::size_t{1} << 16) / sizeof(Slot));
+
+public:
+  /**
+   * @brief Whether a pool can always take over the slabs of another pool on move
+   * assignment, i.e. whether the allocator propagates on move assignment or all of its
+   * instances compare equal.
+   */
+  static constexpr bool always_adopts = SlotTraits::propagate_on_container_move_assignment::value || SlotTraits::is_always_equal::value;
+
+  /**
+   * @brief Constructs a new empty pool.
+   *
+   * No memory is allocated until the first node is created.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr NodePool() : NodePool(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty pool that allocates its slabs using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the slabs.
+   */
+  constexpr explicit NodePool(const Allocator &alloc) noexcept : alloc(alloc) {}
+
+  /**
+   * @brief Destroys the pool.
+   *
+   * All slabs are deallocated. The nodes themselves are not destroyed; destroying them
+   * beforehand is the responsibility of the owner of the pool.
+   *
+   * The time complexity of this operation is O(s), where s is the number of slabs.
+   */
+  constexpr ~NodePool()
+  {
+    deallocate_slabs();
+  }
+
+  constexpr NodePool(const NodePool &) = delete;
+  constexpr NodePool &operator=(const NodePool &) = delete;
+
+  /**
+   * @brief Constructs a new pool that takes ownership of the slabs of another pool.
+   *
+   * @note The other pool is left empty.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The pool to take the slabs from.
+   */
+  constexpr NodePool(NodePool &&other) noexcept
+      : alloc(std::move(other.alloc)),
+        slabs(std::exchange(other.slabs, nullptr)),
+        last(std::exchange(other.last, nullptr)),
+        current(std::exchange(other.current, nullptr)),
+        used(std::exchange(other.used, 0)),
+        next_capacity(std::exchange(other.next_capacity, min_capacity)),
+        free_head(std::exchange(other.free_head, nullptr)),
+        free_tail(std::exchange(other.free_tail, nullptr)) {}
+
+  /**
+   * @brief Deallocates the slabs of this pool, and takes over the slabs of another pool.
+   *
+   * The allocator is moved as well if it propagates on move assignment. The nodes of this
+   * pool are not destroyed; destroying them beforehand is the responsibility of the owner
+   * of the pool.
+   *
+   * @note The other pool is left empty.
+   *
+   * @pre `can_adopt(other)`, as the slabs of the other pool are later deallocated by the
+   * allocator of this pool. Owners whose allocators may differ move their nodes one by
+   * one instead.
+   *
+   * The time complexity of this operation is O(s), where s is the number of slabs of this
+   * pool.
+   *
+   * @param other The pool to take the slabs from.
+   * @return A reference to this pool.
+   */
+  constexpr NodePool &operator=(NodePool &&other) noexcept
+  {
+    assert(can_adopt(other));
+    if (this != &other)
+    {
+      deallocate_slabs();
+      if constexpr (SlotTraits::propagate_on_container_move_assignment::value)
+      {
+        alloc = std::move(other.alloc);
+      }
+      slabs = std::exchange(other.slabs, nullptr);
+      last = std::exchange(other.last, nullptr);
+      current = std::exchange(other.current, nullptr);
+      used = std::exchange(other.used, 0);
+      next_capacity = std::exchange(other.next_capacity, min_capacity);
+      free_head = std::exchange(other.free_head, nullptr);
+      free_tail = std::exchange(other.free_tail, nullptr);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Returns whether this pool can take over the slabs of another pool on move
+   * assignment, i.e. whether the slabs can later be deallocated by the allocator of this
+   * pool.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The pool whose slabs would be taken over.
+   */
+  constexpr bool can_adopt(const NodePool &other) const noexcept
+  {
+    if constexpr (always_adopts)
+    {
+      return true;
+    }
+    else
+    {
+      return alloc == other.alloc;
+    }
+  }
+
+  /**
+   * @brief Swaps the slabs of this pool with the slabs of another pool.
+   *
+   * The allocators are swapped only if the allocator propagates on swap.
+   *
+   * @pre The allocators of both pools compare equal, unless the allocator propagates on
+   * swap, as the slabs of each pool are later deallocated by the allocator of the other.
+   * This is checked by an assertion.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The pool to swap with.
+   */
+  constexpr void swap(NodePool &other) noexcept
+  {
+    assert(SlotTraits::propagate_on_container_swap::value || alloc == other.alloc);
+    if constexpr (SlotTraits::propagate_on_container_swap::value)
+    {
+      std::swap(alloc, other.alloc);
+    }
+    std::swap(slabs, other.slabs);
+    std::swap(last, other.last);
+    std::swap(current, other.current);
+    std::swap(used, other.used);
+    std::swap(next_capacity, other.next_capacity);
+    std::swap(free_head, other.free_head);
+    std::swap(free_tail, other.free_tail);
+  }
+
+  /**
+   * @brief Creates a new node from the given arguments.
+   *
+   * The node is placed in a recycled slot if one is available, otherwise in the next
+   * unused slot of the current slab. A new slab is allocated only if both are exhausted.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param args The arguments forwarded to the constructor of the node.
+   * @return A pointer to the newly created node.
+   */
+  template <typename... Args>
+  constexpr Node *create(Args &&...args)
+  {
+    if consteval
+    {
+      NodeAllocator node_alloc(alloc);
+      Node *node = NodeTraits::allocate(node_alloc, 1);
+      NodeTraits::construct(node_alloc, node, std::forward<Args>(args)...);
+      return node;
+    }
+    else
+    {
+      return std::construct_at(reinterpret_cast<Node *>(acquire()->storage), std::forward<Args>(args)...);
+    }
+  }
+
+  /**
+   * @brief Destroys a node created by this pool and recycles its slot.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param node The node to destroy.
+   */
+  constexpr void destroy(Node *node) noexcept
+  {
+    if consteval
+    {
+      NodeAllocator node_alloc(alloc);
+      NodeTraits::destroy(node_alloc, node);
+      NodeTraits::deallocate(node_alloc, node, 1);
+    }
+    else
+    {
+      std::destroy_at(node);
+      Slot *slot = reinterpret_cast<Slot *>(node);
+      slot->next = free_head;
+      if (free_head == nullptr)
+      {
+        free_tail = slot;
+      }
+      free_head = slot;
+    }
+  }
+
+  /**
+   * @brief Forgets all nodes created by this pool, without destroying them.
+   *
+   * All slabs are kept and their slots are handed out again by later calls to
+   * `create()`, which makes this a cheap way to drop a whole heap between jobs. This
+   * must only be used when the nodes are trivially destructible, or when they have
+   * already been destroyed by other means.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr void release() noexcept
+  {
+    current = slabs;
+    used = 0;
+    free_head = free_tail = nullptr;
+  }
+
+  /**
+   * @brief Takes ownership of the slabs of another pool.
+   *
+   * This method is used when the nodes of another heap are moved into this heap. The
+   * free slots of the other pool are recycled by this pool, and the unused slots of its
+   * current slab are abandoned until the next `release()`.
+   *
+   * @note The other pool is left empty.
+   *
+   * @pre The allocators of both pools compare equal, as the slabs of the other pool are
+   * later deallocated by the allocator of this pool.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The pool to take the slabs from.
+   */
+  constexpr void splice(NodePool &other) noexcept
+  {
+    if (other.slabs == nullptr)
+    {
+      return;
+    }
+
+    if (slabs == nullptr)
+    {
+      std::swap(slabs, other.slabs);
+      std::swap(last, other.last);
+      std::swap(current, other.current);
+      std::swap(used, other.used);
+      std::swap(next_capacity, other.next_capacity);
+    }
+    else
+    {
+      other.last->next = slabs; // the spliced slabs are in use, so they go before `current`
+      slabs = std::exchange(other.slabs, nullptr);
+      other.last = other.current = nullptr;
+      other.used = 0;
+      next_capacity = std::max(next_capacity, other.next_capacity);
+    }
+
+    if (other.free_head != nullptr)
+    {
+      other.free_tail->next = free_head;
+      if (free_head == nullptr)
+      {
+        free_tail = other.free_tail;
+      }
+      free_head = std::exchange(other.free_head, nullptr);
+      other.free_tail = nullptr;
+    }
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the pool.
+   */
+  constexpr Allocator get_allocator() const noexcept
+  {
+    return Allocator(alloc);
+  }
+
+private:
+  [[no_unique_address]] SlotAllocator alloc; ///< The allocator used to allocate the slabs.
+  Slab *slabs = nullptr;                    ///< The first slab owned by the pool.
+  Slab *last = nullptr;                     ///< The last slab owned by the pool.
+  Slab *current = nullptr;                  ///< The slab that new slots are taken from.
+  std::size_t used = 0;                     ///< The number of slots taken from `current`.
+  std::size_t next_capacity = min_capacity; ///< The capacity of the next slab to allocate.
+  Slot *free_head = nullptr;                ///< The first slot in the free list.
+  Slot *free_tail = nullptr;                ///< The last slot in the free list.
+
+  /**
+   * @brief Deallocates every slab owned by the pool, without resetting the pool.
+   *
+   * The time complexity of this operation is O(s), where s is the number of slabs.
+   */
+  constexpr void deallocate_slabs() noexcept
+  {
+    for (Slab *slab = slabs; slab != nullptr;)
+    {
+      Slab *next = slab->next;
+      SlotTraits::deallocate(alloc, reinterpret_cast<Slot *>(slab), header_slots + slab->capacity);
+      slab = next;
+    }
+  }
+
+  /**
+   * @brief Returns the slots of a slab, which follow its header.
+   */
+  static Slot *slots_of(Slab *slab) noexcept
+  {
+    return reinterpret_cast<Slot *>(slab) + header_slots;
+  }
+
+  /**
+   * @brief Returns an unused slot, allocating a new slab if needed.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   */
+  Slot *acquire()
+  {
+    if (free_head != nullptr)
+    {
+      Slot *slot = free_head;
+      free_head = slot->next;
+      if (free_head == nullptr)
+      {
+        free_tail = nullptr;
+      }
+      return slot;
+    }
+
+    if (current == nullptr || used == current->capacity)
+    {
+      if (current != nullptr && current->next != nullptr)
+      {
+        current = current->next;
+      }
+      else
+      {
+        Slab *slab = ::new (SlotTraits::allocate(alloc, header_slots + next_capacity)) Slab{nullptr, next_capacity};
+        next_capacity = std::min(next_capacity * 2, max_capacity);
+        if (slabs == nullptr)
+        {
+          slabs = slab;
+        }
+        else
+        {
+          last->next = slab;
+        }
+        last = current = slab;
+      }
+      used = 0;
+    }
+
+    return slots_of(current) + used++;
+  }
+}; // class NodePool
+
+#endif // NODE_POOL_H
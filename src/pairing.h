@@ -0,0 +1,398 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include "mergeable_heap.h"
+#include "node_pool.h"
+#include "forest.h"
+
+#include <optional>
+#include <queue>
+#include <utility>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class PairingHeap
+ *
+ * @brief A mergeable heap implemented as a pairing heap.
+ *
+ * @details A pairing heap is a single heap-ordered multiway tree. Two trees are linked by
+ * making the root with the larger key the first child of the other root, so insertions and
+ * merges are a single link. When the minimum is extracted, the children of the root are
+ * linked back into one tree using the two-pass pairing strategy: first, the children are
+ * linked in pairs from left to right, and then the resulting trees are linked one by one
+ * from right to left. This gives an amortized O(log n) extract_min.
+ *
+ * Compared to `LazyBinomialHeap`, every node carries only its key and two pointers, and a
+ * link does not maintain any degree, which makes pairing heaps very fast in practice.
+ *
+ * The nodes of the heap are allocated from a per-heap `NodePool`, just like in
+ * `LazyBinomialHeap`.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
+ * moved into the heap in the insert method.
+ * @tparam Allocator The allocator used by the node pool to allocate its slabs.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class PairingHeap final : public MergeableHeapBase<PairingHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<PairingHeap, T>; ///< The non-virtual base of the heap.
+
+private:
+  /**
+   * @struct Node
+   * @brief A node in the heap.
+   *
+   * @note The tree is implemented using the left-child, right-sibling (LCRS) idiom. The
+   * children of a node form a null-terminated singly linked list, and the root has no
+   * siblings.
+   */
+  struct Node
+  {
+    T key;         ///< The key stored in the node.
+    Node *sibling; ///< A pointer to the node's next sibling.
+    Node *child;   ///< A pointer to the node's first child.
+
+    /**
+     * @brief Constructs a new node whose key is constructed in place from the given arguments.
+     *
+     * @param args The arguments forwarded to the constructor of the key.
+     */
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) : key(std::forward<Args>(args)...), sibling(nullptr), child(nullptr) {}
+  };
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr PairingHeap() : PairingHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit PairingHeap(const Allocator &alloc) noexcept : nodes(alloc), root(nullptr) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr PairingHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : PairingHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr PairingHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return PairingHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The nodes are destroyed iteratively, so destroying a degenerate, deep tree does not
+   * overflow the stack.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, or O(s) if `T` is trivially destructible, where s is the number of slabs.
+   */
+  constexpr ~PairingHeap()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * The new node is linked with the root.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    Node *node = nodes.create(std::in_place, std::forward<Args>(args)...);
+    root = root == nullptr ? node : link(root, node);
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * If `T` is trivially destructible, the node pool simply forgets about the nodes.
+   * Otherwise, every node is destroyed iteratively.
+   *
+   * The time complexity of this operation is O(1) if `T` is trivially destructible, and
+   * O(n) otherwise, where n is the number of nodes in the heap.
+   */
+  constexpr void clear() noexcept
+  {
+    if consteval
+    {
+      forest::destroy(root, nodes);
+    }
+    else
+    {
+      if constexpr (std::is_trivially_destructible_v<Node>)
+      {
+        nodes.release();
+      }
+      else
+      {
+        forest::destroy(root, nodes);
+      }
+    }
+
+    root = nullptr;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is stored in
+   * the root.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (root == nullptr)
+    {
+      return std::nullopt;
+    }
+    return std::cref(root->key);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The root is removed, and its children are linked into the new root using the
+   * two-pass pairing strategy.
+   *
+   * The time complexity of this operation is O(log n) amortized, and O(n) in the worst
+   * case, where n is the number of nodes in the heap.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    Node *min_node = root;
+    if (min_node == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    root = pair(min_node->child);
+
+    T key = std::move(min_node->key);
+    nodes.destroy(min_node);
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The roots of both heaps are linked, and the node pool of the other heap is spliced
+   * into the node pool of this heap.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the slabs of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(PairingHeap &other)
+  {
+    if (other.root != nullptr)
+    {
+      root = root == nullptr ? other.root : link(root, other.root);
+    }
+    nodes.splice(other.nodes);
+
+    other.root = nullptr;
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys of the nodes in the heap using a breadth-first traversal
+   * starting from the root.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
+   */
+  void print() const
+  {
+    if (root == nullptr)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    std::queue<Node *> q;
+    q.push(root);
+    while (!q.empty())
+    {
+      Node *curr = q.front();
+      q.pop();
+      std::cout << curr->key << ", ";
+      for (Node *child = curr->child; child != nullptr; child = child->sibling)
+      {
+        q.push(child);
+      }
+    }
+
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap.
+   *
+   * The time complexity of this operation is O(n log n), where n is the number of nodes
+   * in the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(PairingHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return nodes.get_allocator();
+  }
+
+private:
+  NodePool<Node, Allocator> nodes; ///< The pool that the nodes of the heap are allocated from.
+  Node *root;                      ///< A pointer to the root of the tree, which holds the minimum key.
+
+  /**
+   * @brief Links two trees.
+   *
+   * The root with the larger key becomes the first child of the other root. On equal keys,
+   * `tree1` stays the root. The sibling pointer of the resulting root is left untouched.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param tree1 The first tree to link.
+   * @param tree2 The second tree to link.
+   * @return The resulting tree after the link.
+   */
+  static constexpr Node *link(Node *tree1, Node *tree2) noexcept
+  {
+    if (tree2->key < tree1->key)
+    {
+      std::swap(tree1, tree2);
+    }
+    tree2->sibling = tree1->child;
+    tree1->child = tree2;
+    return tree1;
+  }
+
+  /**
+   * @brief Links a list of sibling trees into a single tree, using two-pass pairing.
+   *
+   * In the first pass the trees are linked in pairs from left to right, and the results
+   * are pushed onto a stack threaded through their sibling pointers. In the second pass
+   * the stack is popped, i.e. the pairs are visited from right to left, and each pair is
+   * linked into the accumulated tree. Both passes are iterative.
+   *
+   * The time complexity of this operation is O(k), where k is the number of trees in the
+   * list.
+   *
+   * @param first The first tree in a null-terminated list of sibling trees, or `nullptr`.
+   * @return The root of the resulting tree, or `nullptr` if the list was empty.
+   */
+  static constexpr Node *pair(Node *first) noexcept
+  {
+    Node *pairs = nullptr;
+    while (first != nullptr)
+    {
+      Node *tree1 = first;
+      Node *tree2 = tree1->sibling;
+      if (tree2 == nullptr)
+      {
+        tree1->sibling = pairs;
+        pairs = tree1;
+        break;
+      }
+      first = tree2->sibling;
+
+      Node *tree = link(tree1, tree2);
+      tree->sibling = pairs;
+      pairs = tree;
+    }
+
+    if (pairs == nullptr)
+    {
+      return nullptr;
+    }
+
+    Node *result = pairs;
+    pairs = pairs->sibling;
+    while (pairs != nullptr)
+    {
+      Node *next = pairs->sibling;
+      result = link(result, pairs);
+      pairs = next;
+    }
+    result->sibling = nullptr;
+    return result;
+  }
+}; // class PairingHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `PairingHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T>
+  using PairingHeap = ::PairingHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // PAIRING_HEAP_H
@@ -0,0 +1,406 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include "mergeable_heap.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class RadixHeap
+ *
+ * @brief A monotone mergeable heap for unsigned integer keys.
+ *
+ * @details A radix heap only accepts keys that are not smaller than the last extracted
+ * minimum, which is the case in event loops and in Dijkstra's algorithm. It keeps one
+ * bucket per bit of `T`, plus one bucket for keys equal to the last extracted minimum: a
+ * key is stored in the bucket whose index is the position of the highest bit in which it
+ * differs from the last extracted minimum. Hence the keys of a lower bucket are always
+ * smaller than the keys of a higher bucket.
+ *
+ * When the bucket of keys equal to the last extracted minimum runs empty, the lowest
+ * non-empty bucket is redistributed relative to its own minimum, which becomes the new
+ * last extracted minimum. Every key moves to a strictly lower bucket whenever it is
+ * redistributed, so it is moved at most once per bit of `T`. Extractions therefore take
+ * O(log C) amortized time, where C is the largest key, and only the minimum search of the
+ * redistributed bucket compares keys.
+ *
+ * A bitmap of the non-empty buckets is kept, so the lowest non-empty bucket is found with
+ * a single `std::countr_zero`.
+ *
+ * @tparam T The type of the keys stored in the heap, an unsigned integer type.
+ * @tparam Allocator The allocator used to allocate the buckets.
+ */
+template <std::unsigned_integral T, typename Allocator = std::allocator<T>>
+class RadixHeap final : public MergeableHeapBase<RadixHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<RadixHeap, T>; ///< The non-virtual base of the heap.
+
+  static_assert(std::numeric_limits<T>::digits <= 64, "The bucket bitmap holds at most 64 buckets");
+
+private:
+  using Bucket = std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+  static constexpr int bits = std::numeric_limits<T>::digits; ///< The number of non-zero buckets.
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap.
+   *
+   * The time complexity of this operation is O(log C), where C is the largest value of `T`.
+   */
+  constexpr RadixHeap() : RadixHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its buckets using the given allocator.
+   *
+   * The time complexity of this operation is O(log C), where C is the largest value of `T`.
+   *
+   * @param alloc The allocator used to allocate the buckets.
+   */
+  constexpr explicit RadixHeap(const Allocator &alloc) : buckets(make_buckets(alloc, std::make_index_sequence<bits + 1>())), occupied(0), last(0), min(0), size(0) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the buckets.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr RadixHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : RadixHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr RadixHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return RadixHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The time complexity of this operation is O(log C), where C is the largest value of `T`.
+   */
+  constexpr ~RadixHeap() = default;
+
+  /**
+   * @brief Constructs a key from the given arguments, and inserts it into the heap.
+   *
+   * The keys are integers, which are not stored in nodes, so the key is simply constructed
+   * and inserted.
+   *
+   * @param args The arguments forwarded to the constructor of the key.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    insert(T(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is appended to the bucket of the highest bit in which it differs from the
+   * last extracted minimum.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @param key The key to insert.
+   * @throws std::invalid_argument If the key is smaller than the last extracted minimum.
+   */
+  constexpr void insert(T key)
+  {
+    if (key < last)
+    {
+      throw std::invalid_argument("A radix heap only accepts keys not smaller than the last extracted minimum");
+    }
+    push(key);
+    min = size == 0 ? key : std::min(min, key);
+    ++size;
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The last extracted minimum is reset to 0, so any key may be inserted afterwards.
+   *
+   * The time complexity of this operation is O(log C), where C is the largest value of `T`.
+   */
+  constexpr void clear() noexcept
+  {
+    for (Bucket &bucket : buckets)
+    {
+      bucket.clear();
+    }
+    occupied = 0;
+    last = min = 0;
+    size = 0;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * The time complexity of this operation is O(1), because the minimum key is cached.
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+    return std::cref(min);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * If no key equals the last extracted minimum, the lowest non-empty bucket is
+   * redistributed relative to the current minimum first. Then a key equal to the minimum
+   * is removed, and the minimum of the lowest non-empty bucket becomes the new minimum.
+   *
+   * The time complexity of this operation is O(log C) amortized, where C is the largest
+   * key in the heap.
+   *
+   * @return The minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+
+    if (buckets[0].empty())
+    {
+      const int index = lowest();
+      Bucket &bucket = buckets[index];
+      last = min;
+      for (T key : bucket) // every key moves to a lower bucket
+      {
+        push(key);
+      }
+      bucket.clear();
+      occupied &= ~bit(index);
+    }
+
+    buckets[0].pop_back();
+    --size;
+
+    if (size > 0 && buckets[0].empty())
+    {
+      min = std::ranges::min(buckets[lowest()]);
+    }
+    return last;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The buckets are swapped if the other heap holds more keys, so that the keys of the
+   * smaller heap are the ones being moved. The last extracted minimum of the merged heap
+   * is the smaller of the two; if it decreases, the keys of this heap are redistributed
+   * relative to it first. Then the keys of the other heap are inserted one by one.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the buckets may be swapped.
+   *
+   * The time complexity of this operation is O(min(n, m)), where n and m are the number of
+   * keys in the two heaps, or O(n + m) if the last extracted minimum decreases.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(RadixHeap &other)
+  {
+    if (other.size > size)
+    {
+      std::swap(buckets, other.buckets);
+      std::swap(occupied, other.occupied);
+      std::swap(last, other.last);
+      std::swap(min, other.min);
+      std::swap(size, other.size);
+    }
+    if (other.size == 0)
+    {
+      other.clear();
+      return;
+    }
+
+    if (other.last < last)
+    {
+      rebase(other.last);
+    }
+    for (Bucket &bucket : other.buckets)
+    {
+      for (T key : bucket)
+      {
+        push(key);
+      }
+    }
+    min = std::min(min, other.min);
+    size += other.size;
+
+    other.clear();
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys bucket by bucket, in ascending order of buckets.
+   *
+   * The time complexity of this operation is O(n + log C), where n is the number of keys
+   * in the heap.
+   */
+  void print() const
+  {
+    if (size == 0)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    for (const Bucket &bucket : buckets)
+    {
+      for (T key : bucket)
+      {
+        std::cout << key << ", ";
+      }
+    }
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap. Since the temporary heap never extracted
+   * any key, the last extracted minimum of the sorted heap is 0.
+   *
+   * The time complexity of this operation is O(n log C), where n is the number of keys in
+   * the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(RadixHeap(get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(buckets[0].get_allocator());
+  }
+
+private:
+  std::array<Bucket, bits + 1> buckets; ///< The buckets, indexed by the highest bit that differs from `last`.
+  std::uint64_t occupied;               ///< Bit i - 1 is set if bucket i, for i > 0, is not empty.
+  T last;                               ///< The last extracted minimum.
+  T min;                                ///< The minimum key, if the heap is not empty.
+  std::size_t size;                     ///< The number of keys in the heap.
+
+  /**
+   * @brief Constructs the buckets, all using the given allocator.
+   */
+  template <std::size_t... Indices>
+  static constexpr std::array<Bucket, bits + 1> make_buckets(const Allocator &alloc, std::index_sequence<Indices...>)
+  {
+    return {((void)Indices, Bucket(alloc))...};
+  }
+
+  /**
+   * @brief Returns the bitmap bit of a non-zero bucket.
+   */
+  static constexpr std::uint64_t bit(int index) noexcept
+  {
+    return std::uint64_t{1} << (index - 1);
+  }
+
+  /**
+   * @brief Returns the lowest non-empty non-zero bucket.
+   *
+   * @pre At least one non-zero bucket is not empty.
+   */
+  constexpr int lowest() const noexcept
+  {
+    return std::countr_zero(occupied) + 1;
+  }
+
+  /**
+   * @brief Appends a key to its bucket, relative to the last extracted minimum.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @param key The key to append. It must not be smaller than `last`.
+   */
+  constexpr void push(T key)
+  {
+    const int index = std::bit_width(static_cast<T>(key ^ last));
+    buckets[index].push_back(key);
+    if (index > 0)
+    {
+      occupied |= bit(index);
+    }
+  }
+
+  /**
+   * @brief Redistributes all keys relative to a new, not greater, last extracted minimum.
+   *
+   * The time complexity of this operation is O(n + log C), where n is the number of keys
+   * in the heap.
+   *
+   * @param new_last The new last extracted minimum.
+   */
+  constexpr void rebase(T new_last)
+  {
+    std::array<Bucket, bits + 1> old = make_buckets(get_allocator(), std::make_index_sequence<bits + 1>());
+    std::swap(old, buckets);
+    occupied = 0;
+    last = new_last;
+    for (Bucket &bucket : old)
+    {
+      for (T key : bucket)
+      {
+        push(key);
+      }
+    }
+  }
+}; // class RadixHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `RadixHeap` that allocates its buckets from a `std::pmr::memory_resource`.
+   */
+  template <std::unsigned_integral T>
+  using RadixHeap = ::RadixHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // RADIX_HEAP_H
@@ -0,0 +1,277 @@
+#ifndef ROOT_LIST_H
+#define ROOT_LIST_H
+
+#include "binomial_tree.h"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+
+/**
+ * @brief The root lists and cuts of `LazyBinomialHeap`, and hence of `FibonacciHeap`.
+ *
+ * @details The heap keeps its trees in a circular doubly linked root list, linked
+ * through `sibling` and `prev`, which is only consolidated during extract_min. Every node
+ * links to its parent, and the children of a node form a null-terminated list in
+ * descending order of degree, doubly linked as well with `nullptr` before the first child,
+ * which `link` maintains on top of `binomial::link`. This way, any node can be cut from its
+ * parent and moved to the root list in constant time. The order of the keys is passed to
+ * the operations that compare keys.
+ */
+namespace root_list
+{
+  /**
+   * @brief Trees indexed by degree.
+   *
+   * Without cuts, the degree of a tree with k nodes is log2(k). Cascading cuts keep the
+   * degree of a node with k descendants below log_phi(k), where phi is the golden ratio,
+   * i.e. about 1.44 log2(k), hence twice the bits of `size_t` is always large enough.
+   */
+  template <typename Node>
+  using DegreeTable = std::array<Node *, 2 * std::numeric_limits<size_t>::digits>;
+
+  /**
+   * @brief Splices two circular root lists into one.
+   *
+   * The root list containing `other` is inserted right before `root`, i.e. at the end of
+   * the root list when `root` is regarded as its start.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param root A root in the first root list.
+   * @param other A root in the second root list.
+   */
+  template <typename Node>
+  constexpr void splice(Node *root, Node *other) noexcept
+  {
+    Node *root_last = root->prev;
+    Node *other_last = other->prev;
+    root_last->sibling = other;
+    other->prev = root_last;
+    other_last->sibling = root;
+    root->prev = other_last;
+  }
+
+  /**
+   * @brief Unlinks a root from its root list, leaving it as a root list of its own.
+   *
+   * The time complexity of this operation is O(1), because the root list is doubly linked.
+   *
+   * @param node The root to unlink.
+   * @return Another root in the remaining root list, or `nullptr` if `node` was the only root.
+   */
+  template <typename Node>
+  constexpr Node *unlink(Node *node) noexcept
+  {
+    Node *next = node->sibling;
+    if (next == node)
+    {
+      return nullptr;
+    }
+    node->prev->sibling = next;
+    next->prev = node->prev;
+    node->sibling = node->prev = node;
+    return next;
+  }
+
+  /**
+   * @brief Cuts a node from its parent and moves it to a root list.
+   *
+   * The node loses its mark, as it becomes a root.
+   *
+   * The time complexity of this operation is O(1), because the children are doubly linked.
+   *
+   * @param node The node to cut. It must have a parent.
+   * @param root A root in the root list the node is moved to.
+   */
+  template <typename Node>
+  constexpr void cut(Node *node, Node *root) noexcept
+  {
+    Node *parent = node->parent;
+    if (node->prev == nullptr) // node is the first child
+    {
+      parent->child = node->sibling;
+    }
+    else
+    {
+      node->prev->sibling = node->sibling;
+    }
+    if (node->sibling != nullptr)
+    {
+      node->sibling->prev = node->prev;
+    }
+    parent->degree -= 1;
+
+    node->parent = nullptr;
+    node->marked = false;
+    node->sibling = node->prev = node;
+    splice(root, node);
+  }
+
+  /**
+   * @brief Cuts the marked ancestors of a node that has just lost a child.
+   *
+   * Walking up from `node`, every marked node is cut and moved to the root list, until an
+   * unmarked node is found, which is then marked. Roots are never marked.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @param node The node that has just lost a child.
+   * @param root A root in the root list the cut nodes are moved to.
+   */
+  template <typename Node>
+  constexpr void cascading_cut(Node *node, Node *root) noexcept
+  {
+    while (Node *parent = node->parent)
+    {
+      if (!node->marked)
+      {
+        node->marked = true;
+        return;
+      }
+      cut(node, root);
+      node = parent;
+    }
+  }
+
+  /**
+   * @brief Links two trees of the same degree.
+   *
+   * The trees are linked by `binomial::link`, and the new child also gets its parent and
+   * is linked backwards from the former first child.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param tree1 The first tree to link.
+   * @param tree2 The second tree to link.
+   * @param less The order of the keys of the heap.
+   * @return The resulting tree after the link.
+   */
+  template <typename Node, typename Less>
+  constexpr Node *link(Node *tree1, Node *tree2, const Less &less)
+  {
+    Node *root = binomial::link(tree1, tree2, less);
+    Node *child = root->child;
+    if (child->sibling != nullptr)
+    {
+      child->sibling->prev = child;
+    }
+    child->prev = nullptr;
+    child->parent = root;
+    return root;
+  }
+
+  /**
+   * @brief Places a tree in a degree table.
+   *
+   * Whenever the slot of the tree's degree is already taken, the two trees are linked and
+   * the resulting tree moves on to the next slot.
+   *
+   * The time complexity of this operation is O(1) amortized over a sequence of
+   * placements, and O(log n) in the worst case.
+   *
+   * @param degrees The degree table.
+   * @param max_degree The maximum degree placed in the table so far; updated as needed.
+   * @param tree The tree to place. Its sibling pointers are ignored.
+   * @param less The order of the keys of the heap.
+   */
+  template <typename Node, typename Less>
+  constexpr void place(DegreeTable<Node> &degrees, int &max_degree, Node *tree, const Less &less)
+  {
+    while (degrees[tree->degree] != nullptr) // link trees with the same degree
+    {
+      Node *other = std::exchange(degrees[tree->degree], nullptr);
+      tree = link(tree, other, less);
+    }
+    degrees[tree->degree] = tree;
+    max_degree = std::max(max_degree, tree->degree);
+  }
+
+  /**
+   * @brief Splices the trees of a degree table into a root list.
+   *
+   * The trees are spliced in ascending order of degree, and the minimum is updated along
+   * the way.
+   *
+   * The time complexity of this operation is O(d), where d is the maximum degree.
+   *
+   * @param degrees The degree table.
+   * @param max_degree The maximum degree placed in the table.
+   * @param min The root with the minimum key in the root list, or `nullptr` if the list is
+   * empty; updated as needed.
+   * @param less The order of the keys of the heap.
+   */
+  template <typename Node, typename Less>
+  constexpr void splice_trees(const DegreeTable<Node> &degrees, int max_degree, Node *&min, const Less &less)
+  {
+    for (int i = 0; i <= max_degree; ++i)
+    {
+      if (Node *tree = degrees[i]; tree != nullptr)
+      {
+        tree->sibling = tree->prev = tree;
+        if (min == nullptr)
+        {
+          min = tree;
+        }
+        else
+        {
+          splice(min, tree);
+          if (less(tree->key, min->key))
+          {
+            min = tree;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Consolidates a root list and a child list into a new root list.
+   *
+   * Every tree is placed in a table indexed by degree, so that no two trees of the new
+   * root list have the same degree. The trees are then spliced into the new root list in
+   * ascending order of degree, and the new minimum is found along the way, so no separate
+   * pass over the root list is needed. The children lose their parent and their mark as
+   * they become roots. The table lives on the stack, so the operation does not allocate.
+   *
+   * The time complexity of this operation is O(log n) amortized, where n is the number of
+   * nodes in the heap, and O(k) in the worst case, where k is the number of trees in both
+   * lists.
+   *
+   * @param roots Any root in a circular root list, or `nullptr`.
+   * @param children The first tree in a null-terminated list of trees, or `nullptr`.
+   * @param less The order of the keys of the heap.
+   * @return The root with the minimum key in the new root list, or `nullptr` if both lists
+   * are empty.
+   */
+  template <typename Node, typename Less>
+  constexpr Node *consolidate(Node *roots, Node *children, const Less &less)
+  {
+    DegreeTable<Node> degrees{};
+    int max_degree = 0;
+
+    if (roots != nullptr)
+    {
+      roots->prev->sibling = nullptr; // break the circle
+    }
+    for (Node *list : {roots, children})
+    {
+      for (Node *curr = list; curr != nullptr;)
+      {
+        Node *next = curr->sibling;
+        curr->parent = nullptr;
+        curr->marked = false;
+        place(degrees, max_degree, curr, less);
+        curr = next;
+      }
+    }
+
+    Node *min = nullptr;
+    splice_trees(degrees, max_degree, min, less);
+    return min;
+  }
+} // namespace root_list
+
+#endif // ROOT_LIST_H
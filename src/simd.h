@@ -0,0 +1,230 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86_AVAILABLE 1
+#else
+#define SIMD_X86_AVAILABLE 0
+#endif
+
+/**
+ * @brief Minimum-search kernels for contiguous keys.
+ *
+ * @details `simd::argmin` returns the index of the first minimum key in a contiguous array.
+ * For `int32_t`, `int64_t`, `float` and `double` keys on x86, the search is performed by an
+ * AVX2 or SSE4.1 kernel, which is chosen once at runtime according to the features of the
+ * CPU. The SSE kernel for `int64_t` needs SSE4.2 instead, as the 64-bit signed compare
+ * (`pcmpgtq`) was only added there. Every other key type, every other platform and every
+ * constant evaluation use the portable scalar loop.
+ *
+ * The vector kernels keep, in every lane, the minimum key seen so far along with its index,
+ * and reduce the lanes at the end, so the whole search is a single branch-free pass.
+ */
+namespace simd
+{
+  /**
+   * @brief Returns the index of the first minimum key in `keys[0, count)`.
+   *
+   * The time complexity of this operation is O(count).
+   *
+   * @pre `count > 0`.
+   */
+  template <typename T>
+  constexpr std::size_t argmin_scalar(const T *keys, std::size_t count) noexcept
+  {
+    std::size_t min = 0;
+    for (std::size_t i = 1; i < count; ++i)
+    {
+      if (keys[i] < keys[min])
+      {
+        min = i;
+      }
+    }
+    return min;
+  }
+
+  /**
+   * @brief Whether `argmin` may use a vector kernel for keys of type `T`.
+   */
+  template <typename T>
+  inline constexpr bool vectorizable = SIMD_X86_AVAILABLE &&
+                                       (std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t> ||
+                                        std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+#if SIMD_X86_AVAILABLE
+  namespace detail
+  {
+    /**
+     * @brief A single-pass argmin over `Lanes` keys at a time, using GCC vector extensions.
+     *
+     * This function carries no target of its own; it is inlined into the kernels below,
+     * which compile it for their instruction set.
+     *
+     * @pre `count > 0`, and `count` fits in the index lanes.
+     */
+    template <typename T, std::size_t Lanes>
+    [[gnu::always_inline]] inline std::size_t argmin_lanes(const T *keys, std::size_t count) noexcept
+    {
+      using I = std::conditional_t<sizeof(T) == 8, std::int64_t, std::int32_t>;
+      typedef T Vector __attribute__((vector_size(sizeof(T) * Lanes)));
+      typedef I IndexVector __attribute__((vector_size(sizeof(T) * Lanes)));
+
+      if (count < 2 * Lanes)
+      {
+        return argmin_scalar(keys, count);
+      }
+
+      Vector best;
+      __builtin_memcpy(&best, keys, sizeof(best));
+      IndexVector index{};
+      for (std::size_t lane = 0; lane < Lanes; ++lane)
+      {
+        index[lane] = static_cast<I>(lane);
+      }
+      IndexVector best_index = index;
+
+      std::size_t i = Lanes;
+      for (; i + Lanes <= count; i += Lanes)
+      {
+        Vector block;
+        __builtin_memcpy(&block, keys + i, sizeof(block));
+        index += static_cast<I>(Lanes);
+        IndexVector less = block < best; // strict, so every lane keeps its first minimum
+        best = less ? block : best;
+        best_index = less ? index : best_index;
+      }
+
+      T min_key = best[0];
+      std::size_t min = static_cast<std::size_t>(best_index[0]);
+      for (std::size_t lane = 1; lane < Lanes; ++lane)
+      {
+        const std::size_t lane_index = static_cast<std::size_t>(best_index[lane]);
+        if (best[lane] < min_key || (best[lane] == min_key && lane_index < min))
+        {
+          min_key = best[lane];
+          min = lane_index;
+        }
+      }
+
+      for (; i < count; ++i) // the remaining keys all come after `min`
+      {
+        if (keys[i] < min_key)
+        {
+          min_key = keys[i];
+          min = i;
+        }
+      }
+      return min;
+    }
+
+    [[gnu::target("avx2")]] inline std::size_t argmin_avx2(const std::int32_t *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<std::int32_t, 8>(keys, count);
+    }
+
+    [[gnu::target("avx2")]] inline std::size_t argmin_avx2(const std::int64_t *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<std::int64_t, 4>(keys, count);
+    }
+
+    [[gnu::target("avx2")]] inline std::size_t argmin_avx2(const float *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<float, 8>(keys, count);
+    }
+
+    [[gnu::target("avx2")]] inline std::size_t argmin_avx2(const double *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<double, 4>(keys, count);
+    }
+
+    [[gnu::target("sse4.1")]] inline std::size_t argmin_sse41(const std::int32_t *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<std::int32_t, 4>(keys, count);
+    }
+
+    [[gnu::target("sse4.1")]] inline std::size_t argmin_sse41(const float *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<float, 4>(keys, count);
+    }
+
+    [[gnu::target("sse4.1")]] inline std::size_t argmin_sse41(const double *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<double, 2>(keys, count);
+    }
+
+    [[gnu::target("sse4.2")]] inline std::size_t argmin_sse42(const std::int64_t *keys, std::size_t count) noexcept
+    {
+      return argmin_lanes<std::int64_t, 2>(keys, count);
+    }
+
+    /**
+     * @brief Returns the best kernel for keys of type `T` on the running CPU.
+     *
+     * The CPU features are queried once per key type; later calls return the cached kernel.
+     */
+    template <typename T>
+    inline auto kernel() noexcept
+    {
+      using Kernel = std::size_t (*)(const T *, std::size_t) noexcept;
+      static const Kernel selected = []() -> Kernel
+      {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+          return static_cast<Kernel>(&argmin_avx2);
+        }
+        if constexpr (std::is_same_v<T, std::int64_t>)
+        {
+          if (__builtin_cpu_supports("sse4.2"))
+          {
+            return &argmin_sse42;
+          }
+        }
+        else if (__builtin_cpu_supports("sse4.1"))
+        {
+          return static_cast<Kernel>(&argmin_sse41);
+        }
+        return &argmin_scalar<T>;
+      }();
+      return selected;
+    }
+  } // namespace detail
+#endif
+
+  /**
+   * @brief Returns the index of the first minimum key in `keys[0, count)`.
+   *
+   * Uses a vector kernel if `vectorizable<T>` holds and the function is not constant
+   * evaluated, and the scalar loop otherwise.
+   *
+   * The time complexity of this operation is O(count).
+   *
+   * @pre `count > 0` and `count < 2^31`. Floating-point keys must not be NaN.
+   */
+  template <typename T>
+  constexpr std::size_t argmin(const T *keys, std::size_t count) noexcept
+  {
+    if consteval
+    {
+      return argmin_scalar(keys, count);
+    }
+    else
+    {
+#if SIMD_X86_AVAILABLE
+      if constexpr (vectorizable<T>)
+      {
+        return detail::kernel<T>()(keys, count);
+      }
+#endif
+      return argmin_scalar(keys, count);
+    }
+  }
+} // namespace simd
+
+#undef SIMD_X86_AVAILABLE
+
+#endif // SIMD_H
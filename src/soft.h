@@ -0,0 +1,626 @@
+#ifndef SOFT_HEAP_H
+#define SOFT_HEAP_H
+
+#include "mergeable_heap.h"
+#include "node_pool.h"
+
+#include <array>
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class SoftHeap
+ *
+ * @brief A mergeable heap that trades exactness for speed, by corrupting a bounded
+ * fraction of its keys.
+ *
+ * @details This mergeable heap is implemented using the soft heap of Kaplan, Tarjan and
+ * Zwick ("Soft heaps simplified"), with the list sizes of Kaplan and Zwick, which both
+ * simplify Chazelle's soft heap. The heap is a list of heap-ordered binary trees with
+ * distinct ranks, like a binomial heap. Every node holds a list of keys and a common key
+ * (ckey), which is an upper bound on all of them; the trees are heap-ordered by ckeys.
+ * When a node runs out of keys, it refills its list from its child with the smaller ckey,
+ * taking over that ckey. Above rank r, a node keeps refilling until it holds about
+ * (3/2)^(rank - r) lists, so the keys travel up the trees in groups ("car pooling"). A key
+ * whose ckey has been raised above its own value is said to be corrupted: it is extracted
+ * later than its own value would suggest.
+ *
+ * For an error rate ε, choosing r = 2 + 2⌈log2(1 / ε)⌉ guarantees that at most ε n keys
+ * are corrupted at any time, where n is the number of insertions, while insert takes O(1)
+ * and extract_min takes O(log 1/ε) amortized time, independently of the number of keys.
+ * This makes soft heaps useful for approximate selection, e.g. quantile estimation and
+ * top-k queries over huge streams. With ε = 0, which is the default, no key is ever
+ * corrupted, and the heap is an exact mergeable heap with O(log n) amortized extract_min.
+ *
+
+ *
+ * The nodes and the keys of the heap are allocated from two per-heap `NodePool`s.
+ *
+ * @tparam T The type of the elements stored in the heap. `T` must be copyable, as the
+ * ckeys are copies of keys.
+ * @tparam Allocator The allocator used by the node pools to allocate their slabs.
+ */
+template <std::copyable T, typename Allocator = std::allocator<T>>
+class SoftHeap final : public MergeableHeapBase<SoftHeap<T, Allocator>, T>
+{
+  using Base = MergeableHeapBase<SoftHeap, T>; ///< The non-virtual base of the heap.
+
+private:
+  /**
+   * @struct Item
+   * @brief A key in the list of a node.
+   */
+  struct Item
+  {
+    T key;      ///< The key itself.
+    Item *next; ///< A pointer to the next key in the same list.
+
+    /**
+     * @brief Constructs a new item whose key is constructed in place from the given arguments.
+     *
+     * @param args The arguments forwarded to the constructor of the key.
+     */
+    template <typename... Args>
+    constexpr explicit Item(std::in_place_t, Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) : key(std::forward<Args>(args)...), next(nullptr) {}
+  };
+
+  /**
+   * @struct Node
+   * @brief A node in one of the trees of the heap.
+   */
+  struct Node
+  {
+    T ckey;            ///< The common key, an upper bound on the keys in the list.
+    std::size_t rank;  ///< The rank of the node, one more than the rank of its children.
+    Node *left;        ///< A pointer to the node's left child.
+    Node *right;       ///< A pointer to the node's right child, if it has two children.
+    Item *head;        ///< A pointer to the first key in the list.
+    Item *tail;        ///< A pointer to the last key in the list.
+    std::size_t count; ///< The number of keys in the list.
+    std::size_t exact; ///< The number of keys in the list that are equal to the ckey.
+
+    /**
+     * @brief Constructs a new leaf holding a single key.
+     *
+     * @param item The key of the leaf, which is not corrupted.
+     */
+    constexpr Node(Item *item) : ckey(item->key), rank(0), left(nullptr), right(nullptr), head(item), tail(item), count(1), exact(1) {}
+
+    /**
+     * @brief Constructs a new node with an empty list, linking two trees of equal rank.
+     *
+     * @param left The left child of the node.
+     * @param right The right child of the node.
+     */
+    constexpr Node(Node *left, Node *right) : ckey(left->ckey), rank(left->rank + 1), left(left), right(right), head(nullptr), tail(nullptr), count(0), exact(0) {}
+  };
+
+  static constexpr std::size_t max_rank = std::numeric_limits<std::size_t>::digits;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @brief Constructs a new empty heap that corrupts no keys.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr SoftHeap() : SoftHeap(0.0) {}
+
+  /**
+   * @brief Constructs a new empty heap that corrupts no keys and allocates its nodes using
+   * the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit SoftHeap(const Allocator &alloc) : SoftHeap(0.0, alloc) {}
+
+  /**
+   * @brief Constructs a new empty heap with the given error rate.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param epsilon The error rate: at most `epsilon` times the number of insertions keys
+   * are corrupted at any time. Zero means that no key is ever corrupted.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   * @throws std::invalid_argument If `epsilon` does not lie in [0, 1].
+   */
+  constexpr explicit SoftHeap(double epsilon, const Allocator &alloc = Allocator()) : nodes(alloc), items(alloc), roots{}, suffix_min{}, targets{}, epsilon(epsilon), size(0), corrupted_count(0)
+  {
+    if (!(epsilon >= 0.0 && epsilon <= 1.0))
+    {
+      throw std::invalid_argument("The error rate of a soft heap must lie in [0, 1]");
+    }
+
+    // r = 2 + 2⌈log2(1 / ε)⌉, or no car pooling at all if ε = 0
+    std::size_t r = 2;
+    if (epsilon == 0.0)
+    {
+      r = max_rank;
+    }
+    else
+    {
+      for (double bound = epsilon; bound < 1.0; bound *= 2)
+      {
+        r += 2;
+      }
+    }
+
+    std::size_t target = 1;
+    for (std::size_t rank = 0; rank < max_rank; ++rank)
+    {
+      if (rank > r && target < std::numeric_limits<std::size_t>::max() / 2)
+      {
+        target = (3 * target + 1) / 2;
+      }
+      targets[rank] = target;
+    }
+  }
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last), that
+   * corrupts no keys.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr SoftHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : SoftHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range, that corrupts no keys.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr SoftHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return SoftHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
+
+  /**
+   * @brief Destroys the heap.
+   *
+   * The trees are destroyed iteratively.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the
+   * heap, or O(s) if `T` is trivially destructible, where s is the number of slabs.
+   */
+  constexpr ~SoftHeap()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
+   *
+   * A new leaf of rank 0 is added to the root list, linking trees of equal rank like
+   * carries in binary addition.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   */
+  template <typename... Args>
+  constexpr void emplace(Args &&...args)
+  {
+    Node *tree = nodes.create(items.create(std::in_place, std::forward<Args>(args)...));
+    std::size_t rank = 0;
+    for (; roots[rank] != nullptr; ++rank)
+    {
+      tree = link(std::exchange(roots[rank], nullptr), tree);
+    }
+    roots[rank] = tree;
+    update_suffix_min(rank);
+    ++size;
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
+  }
+
+  /**
+   * @brief Removes all keys from the heap.
+   *
+   * The time complexity of this operation is O(1) if `T` is trivially destructible, and
+   * O(n) otherwise, where n is the number of keys in the heap.
+   */
+  constexpr void clear() noexcept
+  {
+    if consteval
+    {
+      for (Node *root : roots)
+      {
+        destroy(root);
+      }
+    }
+    else
+    {
+      if constexpr (std::is_trivially_destructible_v<Node> && std::is_trivially_destructible_v<Item>)
+      {
+        nodes.release();
+        items.release();
+      }
+      else
+      {
+        for (Node *root : roots)
+        {
+          destroy(root);
+        }
+      }
+    }
+
+    roots.fill(nullptr);
+    suffix_min.fill(nullptr);
+    size = 0;
+    corrupted_count = 0;
+  }
+
+  /**
+   * @brief Returns the minimum key in the heap.
+   *
+   * This is a key of the root with the minimum ckey, which is found through the suffix
+   * minima of the root list. The key is the minimum key of the heap unless some keys are
+   * corrupted, in which case keys smaller than it may still be in the heap.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
+   */
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const noexcept
+  {
+    if (suffix_min[0] == nullptr)
+    {
+      return std::nullopt;
+    }
+    return std::cref(suffix_min[0]->head->key);
+  }
+
+  /**
+   * @brief Removes and returns the minimum key in the heap.
+   *
+   * The first key of the root with the minimum ckey is removed. If the root runs out of
+   * keys, it is refilled from its children, or removed if it has none, and only then are
+   * the suffix minima of the root list updated, in O(log n) time; otherwise the ckey of
+   * the root, and hence every suffix minimum, is unchanged.
+   *
+   * The time complexity of this operation is O(log 1/ε) amortized, or O(log n) amortized
+   * if ε = 0.
+   *
+   * @return The minimum key, as returned by `minimum`, or `std::nullopt` if the heap is
+   * empty.
+   */
+  constexpr std::optional<T> extract_min()
+  {
+    Node *root = suffix_min[0];
+    if (root == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    Item *item = root->head;
+    root->head = item->next;
+    --root->count;
+    if (item->key < root->ckey)
+    {
+      --corrupted_count;
+    }
+    else
+    {
+      --root->exact;
+    }
+    --size;
+
+    if (root->count == 0) // only then can the ckey of the root change, or the root disappear
+    {
+      const std::size_t rank = root->rank;
+      root->tail = nullptr;
+      sift(root);
+      if (root->count == 0)
+      {
+        nodes.destroy(root);
+        roots[rank] = nullptr;
+      }
+      update_suffix_min(rank);
+    }
+
+    T key = std::move(item->key);
+    items.destroy(item);
+    return key;
+  }
+
+  /**
+   * @brief Merges another heap into this heap.
+   *
+   * The root lists of both heaps are added like two binary numbers, linking trees of
+   * equal rank, and the node pools of the other heap are spliced into the node pools of
+   * this heap. The merged heap keeps the error rate of this heap.
+   *
+   * @note The other heap is left empty after the merge.
+   *
+   * @pre The allocators of both heaps compare equal, as the slabs of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
+   * The time complexity of this operation is O(log n + log m) amortized, where n and m are
+   * the number of keys in the two heaps.
+   *
+   * @param other The heap to merge into this heap.
+   */
+  constexpr void merge(SoftHeap &other)
+  {
+    Node *carry = nullptr;
+    for (std::size_t rank = 0; rank < max_rank; ++rank)
+    {
+      Node *trees[3];
+      std::size_t count = 0;
+      for (Node *tree : {roots[rank], std::exchange(other.roots[rank], nullptr), carry})
+      {
+        if (tree != nullptr)
+        {
+          trees[count++] = tree;
+        }
+      }
+
+      roots[rank] = count % 2 == 1 ? trees[count - 1] : nullptr;
+      carry = count >= 2 ? link(trees[0], trees[1]) : nullptr;
+    }
+    update_suffix_min(max_rank - 1);
+
+    nodes.splice(other.nodes);
+    items.splice(other.items);
+    size += std::exchange(other.size, 0);
+    corrupted_count += std::exchange(other.corrupted_count, 0);
+    other.suffix_min.fill(nullptr);
+  }
+
+  /**
+   * @brief Prints the heap.
+   *
+   * This method prints the keys of every tree, from the smallest rank to the largest,
+   * using a breadth-first traversal of the nodes starting from the root.
+   *
+   * The time complexity of this operation is O(n), where n is the number of keys in the heap.
+   */
+  void print() const
+  {
+    if (size == 0)
+    {
+      std::cout << "empty.";
+      return;
+    }
+
+    std::queue<Node *> q;
+    for (Node *root : roots)
+    {
+      if (root != nullptr)
+      {
+        q.push(root);
+      }
+    }
+    while (!q.empty())
+    {
+      Node *curr = q.front();
+      q.pop();
+      for (Item *item = curr->head; item != nullptr; item = item->next)
+      {
+        std::cout << item->key << ", ";
+      }
+      for (Node *child : {curr->left, curr->right})
+      {
+        if (child != nullptr)
+        {
+          q.push(child);
+        }
+      }
+    }
+
+    std::cout << "\b\b.";
+  }
+
+  /**
+   * @brief Sorts the heap in ascending order.
+   *
+   * This method extracts the minimum key from the heap until the heap is empty.
+   * The extracted keys are then inserted into a temporary heap, which is
+   * then merged back into the original heap. If keys were corrupted, they are
+   * extracted, and thus sorted, out of order.
+   *
+   * The time complexity of this operation is O(n log 1/ε), or O(n log n) if ε = 0, where
+   * n is the number of keys in the heap.
+   */
+  void sort()
+  {
+    this->Base::sort(SoftHeap(epsilon, get_allocator()));
+  }
+
+  /**
+   * @brief Returns the number of corrupted keys in the heap, i.e. the keys whose ckey is
+   * larger than the key itself.
+   *
+   * The time complexity of this operation is O(1).
+   */
+  constexpr std::size_t corrupted() const noexcept
+  {
+    return corrupted_count;
+  }
+
+  /**
+   * @brief Returns the error rate of the heap.
+   */
+  constexpr double error_rate() const noexcept
+  {
+    return epsilon;
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return nodes.get_allocator();
+  }
+
+private:
+  NodePool<Node, Allocator> nodes;               ///< The pool that the nodes of the heap are allocated from.
+  NodePool<Item, Allocator> items;               ///< The pool that the keys of the heap are allocated from.
+  std::array<Node *, max_rank> roots;            ///< The root of rank i, or `nullptr` if there is none.
+  std::array<Node *, max_rank + 1> suffix_min;   ///< The root with the minimum ckey among the roots of rank i and above.
+  std::array<std::size_t, max_rank> targets;     ///< The number of keys that a node of rank i refills its list up to.
+  double epsilon;                                ///< The error rate of the heap.
+  std::size_t size;                              ///< The number of keys in the heap.
+  std::size_t corrupted_count;                   ///< The number of corrupted keys in the heap.
+
+  /**
+   * @brief Links two trees of equal rank under a new node, and fills its list.
+   *
+   * The time complexity of this operation is O(1) amortized.
+   *
+   * @return The root of the linked tree, whose rank is one more than the rank of both trees.
+   */
+  constexpr Node *link(Node *tree1, Node *tree2)
+  {
+    Node *root = nodes.create(tree1, tree2);
+    sift(root);
+    return root;
+  }
+
+  /**
+   * @brief Refills the list of a node from its children.
+   *
+   * While the node holds fewer keys than its target and has children, the list of its
+   * child with the smaller ckey is appended to its list, and the node takes over the ckey
+   * of that child. If the ckey rises, the keys that were equal to the old ckey become
+   * corrupted. The emptied child is then refilled in turn, or removed if it is a leaf.
+   * The recursion depth is bounded by the rank of the node.
+   *
+   * The time complexity of this operation is O(1) amortized per key that is moved up.
+   *
+   * @param node The node to refill.
+   */
+  constexpr void sift(Node *node)
+  {
+    while (node->count < targets[node->rank] && node->left != nullptr)
+    {
+      if (node->right != nullptr && node->right->ckey < node->left->ckey)
+      {
+        std::swap(node->left, node->right);
+      }
+
+      Node *child = node->left;
+      if (node->ckey < child->ckey)
+      {
+        corrupted_count += std::exchange(node->exact, 0);
+      }
+      node->ckey = child->ckey;
+      node->exact += std::exchange(child->exact, 0);
+      node->count += std::exchange(child->count, 0);
+      if (node->head == nullptr)
+      {
+        node->head = child->head;
+      }
+      else
+      {
+        node->tail->next = child->head;
+      }
+      node->tail = child->tail;
+      child->head = child->tail = nullptr;
+
+      if (child->left == nullptr)
+      {
+        node->left = std::exchange(node->right, nullptr);
+        nodes.destroy(child);
+      }
+      else
+      {
+        sift(child);
+      }
+    }
+  }
+
+  /**
+   * @brief Recomputes the suffix minima of the root list, from the given rank down to 0.
+   *
+   * The time complexity of this operation is O(rank).
+   */
+  constexpr void update_suffix_min(std::size_t rank) noexcept
+  {
+    for (std::size_t i = rank + 1; i-- > 0;)
+    {
+      Node *next = suffix_min[i + 1];
+      Node *root = roots[i];
+      suffix_min[i] = root != nullptr && (next == nullptr || !(next->ckey < root->ckey)) ? root : next;
+    }
+  }
+
+  /**
+   * @brief Destroys a tree and the keys in its lists.
+   *
+   * A node with a left child is rotated right until the current node has no left child,
+   * at which point its keys and the node itself are destroyed and the traversal continues
+   * with its right child. This way, no recursion and no auxiliary memory are needed.
+   *
+   * The time complexity of this operation is O(k), where k is the number of nodes and
+   * keys in the destroyed tree.
+   *
+   * @param node The root of the tree to destroy, or `nullptr`.
+   */
+  constexpr void destroy(Node *node) noexcept
+  {
+    while (node != nullptr)
+    {
+      if (Node *left = node->left; left != nullptr)
+      {
+        node->left = left->right; // rotate right: the left child becomes the parent
+        left->right = node;
+        node = left;
+      }
+      else
+      {
+        for (Item *item = node->head; item != nullptr;)
+        {
+          items.destroy(std::exchange(item, item->next));
+        }
+        Node *right = node->right;
+        nodes.destroy(node);
+        node = right;
+      }
+    }
+  }
+}; // class SoftHeap
+
+namespace pmr
+{
+  /**
+   * @brief A `SoftHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <std::copyable T>
+  using SoftHeap = ::SoftHeap<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+#endif // SOFT_HEAP_H
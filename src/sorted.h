@@ -1,7 +1,14 @@
 #ifndef SORTED_HEAP_H
 #define SORTED_HEAP_H
 
+#include <algorithm>
+#include <cassert>
 #include <functional>
+#include <memory>
+#include <utility>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
 
 #include "mergeable_heap.h"
 
@@ -13,12 +20,27 @@
  * @details This mergeable heap is implemented using a sorted linked list. The heap is
  * maintained in a sorted order, where the minimum key is always at the head of the list.
  *
+ * `push` returns a handle to the inserted key, which can later be used to decrease the key
+ * with `decrease_key`, or to remove it with `erase`. As the list is singly linked, both
+ * search for the node's predecessor, and a decreased key is moved forward to its new
+ * position, so both take O(n) time, like insert.
+ *
  * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
- * moved into the heap in the insert method.
+ * moved into the heap in the insert method, and move-assignable, as it is reassigned in
+ * the decrease_key method.
+ * @tparam Compare The strict weak ordering of the projected keys. A stateless comparator
+ * takes no space in the heap.
+ * @tparam Projection The projection applied to the keys before they are compared.
+ * @tparam Allocator The allocator used to allocate the nodes of the heap. It is rebound
+ * to the node type, so a `std::pmr::polymorphic_allocator` keeps all nodes of a heap in
+ * the memory resource it was given.
  */
-template <typename T>
-class SortedLinkedHeap : public MergeableHeap<T>
+template <typename T, typename Compare = std::less<>, typename Projection = std::identity, typename Allocator = std::allocator<T>>
+class SortedLinkedHeap final : public MergeableHeapBase<SortedLinkedHeap<T, Compare, Projection, Allocator>, T, Compare, Projection>
 {
+  using Base = MergeableHeapBase<SortedLinkedHeap, T, Compare, Projection>; ///< The non-virtual base of the heap.
+  friend Base;
+
 private:
   struct Node
   {
@@ -26,11 +48,12 @@ private:
     Node *next; ///< A pointer to the next node in the linked list.
 
     /**
-     * @brief Constructs a new node with the given key.
+     * @brief Constructs a new node whose key is constructed in place from the given arguments.
      *
-     * @param key The key to store in the node. This key is moved into the node.
+     * @param args The arguments forwarded to the constructor of the key.
      */
-    constexpr Node(T key) : key(std::move(key)), next(nullptr) {}
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) : key(std::forward<Args>(args)...), next(nullptr) {}
 
     /**
      * @brief Default destructor.
@@ -40,17 +63,54 @@ private:
     constexpr ~Node() = default;
   };
 
-private:
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+public:
+  using allocator_type = Allocator;
+
   /**
-   * @brief Constructs a new heap with the given key.
+   * @class handle_type
+   * @brief A handle to a key in the heap.
    *
-   * The time complexity of this operation is O(1).
-   *
-   * @param key The key to store in the heap. This key is moved into the heap.
+   * A handle is returned by `push` and `emplace`, and stays valid until its key is extracted
+   * or erased, or the heap is sorted or destroyed. Merging a heap into another keeps its handles
+   * valid; they then refer to keys of the heap that was merged into.
    */
-  constexpr SortedLinkedHeap(T key) : head(new Node(std::move(key))) {}
+  class handle_type
+  {
+  public:
+    /**
+     * @brief Constructs a handle that does not refer to any key.
+     */
+    constexpr handle_type() noexcept = default;
+
+    /**
+     * @brief Returns the key the handle refers to.
+     */
+    constexpr const T &operator*() const noexcept
+    {
+      return node->key;
+    }
+
+    /**
+     * @brief Accesses the key the handle refers to.
+     */
+    constexpr const T *operator->() const noexcept
+    {
+      return &node->key;
+    }
+
+    constexpr bool operator==(const handle_type &) const noexcept = default;
+
+  private:
+    friend class SortedLinkedHeap;
+
+    constexpr explicit handle_type(Node *node) noexcept : node(node) {}
+
+    Node *node = nullptr; ///< The node holding the key.
+  };
 
-public:
   /**
    * @brief Constructs a new empty heap.
    *
@@ -58,7 +118,57 @@ public:
    *
    * The time complexity of this operation is O(1).
    */
-  constexpr SortedLinkedHeap() : head(nullptr) {}
+  constexpr SortedLinkedHeap() : SortedLinkedHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit SortedLinkedHeap(const Allocator &alloc) : SortedLinkedHeap(Compare(), Projection(), alloc) {}
+
+  /**
+   * @brief Constructs a new empty heap that orders its keys using the given comparator and
+   * projection.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param comp The comparator used to order the keys.
+   * @param proj The projection applied to the keys before they are compared.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit SortedLinkedHeap(const Compare &comp, const Projection &proj = Projection(), const Allocator &alloc = Allocator())
+      : comp(comp), proj(proj), alloc(alloc), head(nullptr) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k log k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr SortedLinkedHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : SortedLinkedHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k log k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr SortedLinkedHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return SortedLinkedHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
 
   /**
    * @brief Destroys the heap.
@@ -69,28 +179,150 @@ public:
    */
   constexpr ~SortedLinkedHeap()
   {
-    for (Node *current = head; current != nullptr;)
+    destroy_list(head);
+  }
+
+  /**
+   * @brief Constructs a new heap that takes over the nodes of another heap.
+   *
+   * @note The other heap is left empty.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to move from.
+   */
+  constexpr SortedLinkedHeap(SortedLinkedHeap &&other) noexcept
+      : comp(std::move(other.comp)), proj(std::move(other.proj)), alloc(std::move(other.alloc)), head(std::exchange(other.head, nullptr)) {}
+
+  /**
+   * @brief Replaces the keys of this heap with the keys of another heap.
+   *
+   * The keys of this heap are destroyed. Like the standard containers, the heap then takes
+   * over the nodes of the other heap if its allocator propagates on move assignment or
+   * compares equal to the allocator of the other heap. Otherwise, e.g. for two
+   * `std::pmr::polymorphic_allocator`s with different memory resources, the keys are moved
+   * one by one into nodes allocated by this heap, which invalidates the handles to the keys
+   * of the other heap. If moving a key throws, the keys not moved yet are lost.
+   *
+   * @note The other heap is left empty.
+   *
+   * The time complexity of this operation is O(1), or O(m) if the keys are moved one by
+   * one, where m is the number of nodes in the other heap, plus the time needed to destroy
+   * the keys of this heap.
+   *
+   * @param other The heap to move from.
+   * @return A reference to this heap.
+   */
+  constexpr SortedLinkedHeap &operator=(SortedLinkedHeap &&other) noexcept(NodeTraits::propagate_on_container_move_assignment::value || NodeTraits::is_always_equal::value)
+  {
+    if (this == &other)
+    {
+      return *this;
+    }
+
+    destroy_list(std::exchange(head, nullptr));
+    comp = std::move(other.comp);
+    proj = std::move(other.proj);
+    if (NodeTraits::propagate_on_container_move_assignment::value || alloc == other.alloc)
     {
-      Node *next = current->next;
-      delete current;
-      current = next;
+      if constexpr (NodeTraits::propagate_on_container_move_assignment::value)
+      {
+        alloc = std::move(other.alloc);
+      }
+      head = std::exchange(other.head, nullptr);
     }
+    else
+    {
+      Node **next = &head; // the keys are already sorted, so they are appended in order
+      for (Node *node = std::exchange(other.head, nullptr); node != nullptr;)
+      {
+        Node *after = node->next;
+        *next = create_node(std::move(node->key));
+        next = &(*next)->next;
+        other.destroy_node(node);
+        node = after;
+      }
+    }
+    return *this;
   }
 
   /**
-   * @brief Inserts a key into the heap.
+   * @brief Swaps the keys of this heap with the keys of another heap.
+   *
+   * The comparators and projections are swapped as well, and so are the allocators if they
+   * propagate on swap.
+   *
+   * @pre The allocators of both heaps compare equal, unless they propagate on swap, as for
+   * the standard containers. This is checked by an assertion.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to swap with.
+   */
+  constexpr void swap(SortedLinkedHeap &other) noexcept
+  {
+    assert(NodeTraits::propagate_on_container_swap::value || alloc == other.alloc);
+    std::swap(comp, other.comp);
+    std::swap(proj, other.proj);
+    if constexpr (NodeTraits::propagate_on_container_swap::value)
+    {
+      std::swap(alloc, other.alloc);
+    }
+    std::swap(head, other.head);
+  }
+
+  /**
+   * @brief Swaps the keys of two heaps.
+   */
+  friend constexpr void swap(SortedLinkedHeap &a, SortedLinkedHeap &b) noexcept
+  {
+    a.swap(b);
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
    *
    * This function inserts a new key into the heap. The key is inserted at the correct
    * position in the linked list to maintain the sorted order of the heap.
    *
    * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
    *
-   * @param key The key to insert into the heap. This key is moved into the heap.
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   * @return A handle to the inserted key.
    */
-  constexpr void insert(T key) override
+  template <typename... Args>
+  constexpr handle_type emplace(Args &&...args)
   {
-    SortedLinkedHeap<T> temp(std::move(key));
+    SortedLinkedHeap temp(comp, proj, get_allocator());
+    Node *node = temp.head = temp.create_node(std::forward<Args>(args)...);
     merge(temp);
+    return handle_type(node);
+  }
+
+  /**
+   * @brief Inserts a key into the heap and returns a handle to it.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   * @return A handle to the inserted key.
+   */
+  constexpr handle_type push(T key)
+  {
+    return emplace(std::move(key));
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
   }
 
   /**
@@ -105,7 +337,7 @@ public:
    *
    * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
    */
-  constexpr std::optional<std::reference_wrapper<const T>> minimum() const override
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const
   {
     if (head == nullptr)
     {
@@ -125,7 +357,7 @@ public:
    *
    * @return The minimum key in the heap, or `std::nullopt` if the heap is empty.
    */
-  constexpr std::optional<T> extract_min() override
+  constexpr std::optional<T> extract_min()
   {
     Node *min_node = head;
     if (min_node == nullptr)
@@ -138,8 +370,58 @@ public:
     T key = std::move(min_node->key); // extract the key before deleting the node
 
     min_node->next = nullptr;
-    delete min_node;
+    destroy_node(min_node);
+
+    return key;
+  }
+
+  /**
+   * @brief Decreases a key in the heap.
+   *
+   * The node is unlinked from the list, its key is replaced, and it is linked back in before
+   * the first node whose key is not smaller than the new key. The node itself is not
+   * reallocated, so the handle stays valid.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the heap.
+   *
+   * @param handle A handle to the key to decrease.
+   * @param key The new key. This key is moved into the heap.
+   * @throws std::invalid_argument If the new key is greater than the current key.
+   */
+  constexpr void decrease_key(handle_type handle, T key)
+  {
+    Node *node = handle.node;
+    if (less(node->key, key))
+    {
+      throw std::invalid_argument("The new key is greater than the current key");
+    }
+    unlink(node);
+    node->key = std::move(key);
+
+    Node **next = &head;
+    while (*next != nullptr && less((*next)->key, node->key))
+    {
+      next = &(*next)->next;
+    }
+    node->next = *next;
+    *next = node;
+  }
 
+  /**
+   * @brief Removes a key from the heap and returns it.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, as the list is searched for the node's predecessor.
+   *
+   * @param handle A handle to the key to remove. The handle is invalidated.
+   * @return The removed key.
+   */
+  constexpr T erase(handle_type handle)
+  {
+    Node *node = handle.node;
+    unlink(node);
+    T key = std::move(node->key);
+    destroy_node(node);
     return key;
   }
 
@@ -151,34 +433,35 @@ public:
    *
    * @note The other heap is left empty after the merge.
    *
+   * @pre The allocators of both heaps compare equal, as the nodes of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
    * The time complexity of this operation is O(n + m), where n is the number of nodes
    * in this heap and m is the number of nodes in the other heap.
    *
    * @param other The heap to merge into this heap.
    */
-  constexpr void merge(MergeableHeap<T> &other) override
+  constexpr void merge(SortedLinkedHeap &other)
   {
-    SortedLinkedHeap<T> &other_heap = static_cast<SortedLinkedHeap<T> &>(other);
-
     if (head == nullptr)
     {
-      std::swap(head, other_heap.head);
+      std::swap(head, other.head);
       return;
     }
-    if (other_heap.head == nullptr)
+    if (other.head == nullptr)
     {
       return;
     }
 
     // Initialize pointers
     Node *current = head;
-    Node *other_current = other_heap.head;
+    Node *other_current = other.head;
     Node *prev = nullptr;
 
     // Iterate through both lists
     while (current != nullptr && other_current != nullptr)
     {
-      if (current->key < other_current->key)
+      if (less(current->key, other_current->key))
       {
         // Insert other_current node after prev
         prev = current;
@@ -208,7 +491,7 @@ public:
       prev->next = other_current;
     }
 
-    other_heap.head = nullptr;
+    other.head = nullptr;
   }
 
   /**
@@ -220,7 +503,7 @@ public:
    * The time complexity of this operation is O(n), where n is the number of nodes in the
    * heap.
    */
-  void print() const override
+  void print() const
   {
     if (head == nullptr)
     {
@@ -249,13 +532,136 @@ public:
    * @note The function could be O(1) because the heap is already sorted, but the requirement
    * is to extract the minimum key n times, which is O(n log n).
    */
-  void sort() override
+  void sort()
   {
-    this->MergeableHeap<T>::sort(SortedLinkedHeap<T>{});
+    this->Base::sort(SortedLinkedHeap(comp, proj, get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(alloc);
+  }
+
+  /**
+   * @brief Returns a copy of the comparator used by the heap.
+   */
+  constexpr Compare key_comp() const
+  {
+    return comp;
+  }
+
+  /**
+   * @brief Returns a copy of the projection used by the heap.
+   */
+  constexpr Projection key_proj() const
+  {
+    return proj;
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The batch is sorted once and turned into a sorted list, which is then merged into
+   * the heap in a single linear pass, instead of running a merge for every key.
+   *
+   * The time complexity of this operation is O(k log k + n), where k is the number of
+   * keys and n is the number of nodes in the heap.
+   *
+   * @param keys The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> keys)
+  {
+    std::ranges::sort(keys, comp, proj);
+
+    SortedLinkedHeap batch(comp, proj, get_allocator());
+    Node **next = &batch.head;
+    for (T &key : keys)
+    {
+      *next = batch.create_node(std::move(key));
+      next = &(*next)->next;
+    }
+
+    merge(batch);
   }
 
 private:
-  Node *head; ///< A pointer to the first node in the linked list.
+  [[no_unique_address]] Compare comp;        ///< The comparator used to order the keys.
+  [[no_unique_address]] Projection proj;     ///< The projection applied to the keys before they are compared.
+  [[no_unique_address]] NodeAllocator alloc; ///< The allocator used to allocate the nodes.
+  Node *head;                                ///< A pointer to the first node in the linked list.
+
+  /**
+   * @brief Returns whether the key `a` comes before the key `b` in the order of the heap.
+   */
+  constexpr bool less(const T &a, const T &b) const
+  {
+    return std::invoke(comp, std::invoke(proj, a), std::invoke(proj, b));
+  }
+
+  /**
+   * @brief Allocates a new node, and constructs its key in place from the given arguments.
+   */
+  template <typename... Args>
+  constexpr Node *create_node(Args &&...args)
+  {
+    Node *node = NodeTraits::allocate(alloc, 1);
+    NodeTraits::construct(alloc, node, std::in_place, std::forward<Args>(args)...);
+    return node;
+  }
+
+  /**
+   * @brief Destroys and deallocates every node of a null-terminated list.
+   */
+  constexpr void destroy_list(Node *node) noexcept
+  {
+    while (node != nullptr)
+    {
+      Node *next = node->next;
+      destroy_node(node);
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Destroys and deallocates a node.
+   */
+  constexpr void destroy_node(Node *node) noexcept
+  {
+    NodeTraits::destroy(alloc, node);
+    NodeTraits::deallocate(alloc, node, 1);
+  }
+
+  /**
+   * @brief Unlinks a node from the list.
+   *
+   * The time complexity of this operation is O(n), where n is the number of nodes in the
+   * heap, because the predecessor of the node must be searched for.
+   *
+   * @param node The node to unlink. It must be in the list.
+   */
+  constexpr void unlink(Node *node) noexcept
+  {
+    Node **next = &head;
+    while (*next != node)
+    {
+      next = &(*next)->next;
+    }
+    *next = node->next;
+    node->next = nullptr;
+  }
 }; // class SortedLinkedHeap
 
+namespace pmr
+{
+  /**
+   * @brief A `SortedLinkedHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T, typename Compare = std::less<>, typename Projection = std::identity>
+  using SortedLinkedHeap = ::SortedLinkedHeap<T, Compare, Projection, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
 #endif // SORTED_HEAP_H
\ No newline at end of file
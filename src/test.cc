@@ -1,10 +1,61 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <set>
+#include <vector>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
 #include "sorted.h"
 #include "unsorted.h"
 #include "lazy.h"
+#include "pairing.h"
+#include "fibonacci.h"
+#include "dary.h"
+#include "leftist.h"
+#include "radix.h"
+#include "eager.h"
+#include "minmax.h"
+#include "bucket.h"
+#include "soft.h"
+#include "bheap.h"
+#include "compact.h"
+#include "chunked.h"
+#include "simd.h"
+#include "loader.h"
 
 // g++ -std=c++2b -o test test.cc -lgtest -lpthread
 
+namespace
+{
+  std::size_t allocations = 0; ///< The number of global allocations made so far.
+}
+
+// not inlined, or GCC pairs the inlined malloc and free with the operators and warns of a mismatch
+[[gnu::noinline]] void *operator new(std::size_t size)
+{
+  ++allocations;
+  if (void *ptr = std::malloc(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
 template <typename T>
 class HeapTest : public ::testing::Test
 {
@@ -12,7 +63,11 @@ protected:
   using Heap = T;
 };
 
-using HeapTypes = ::testing::Types<UnsortedLinkedHeap<int>, SortedLinkedHeap<int>, LazyBinomialHeap<int>>;
+using HeapTypes = ::testing::Types<UnsortedLinkedHeap<int>, SortedLinkedHeap<int>, LazyBinomialHeap<int>, CompactUnsortedHeap<int>,
+                                   ChunkedUnsortedHeap<int>, ChunkedUnsortedHeap<int, 3>, PairingHeap<int>,
+                                   ArrayDaryHeap<int>, ArrayDaryHeap<int, 2>,
+                                   LeftistHeap<int>, EagerBinomialHeap<int>, MinMaxHeap<int>, BucketQueue<int>,
+                                   SoftHeap<int>, BHeap<int>, BHeap<int, 64>>;
 
 TYPED_TEST_SUITE(HeapTest, HeapTypes);
 
@@ -138,6 +193,1146 @@ TYPED_TEST(HeapTest, ComplexTest)
   ASSERT_EQ(h1.extract_min(), std::nullopt);
 }
 
+TYPED_TEST(HeapTest, InsertRange)
+{
+  typename TestFixture::Heap h{};
+  h.insert(11);
+  h.insert(0);
+  std::vector<int> keys{5, 3, 9, 1, 3, 8, 2, 6, 4, 10, 7};
+  h.insert_range(keys);
+  h.insert_range(keys.begin(), keys.begin()); // empty range
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ(h.extract_min(), 0);
+  for (int key : keys)
+  {
+    ASSERT_EQ(h.extract_min(), key);
+  }
+  ASSERT_EQ(h.extract_min(), 11);
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TYPED_TEST(HeapTest, RangeConstructor)
+{
+  const std::vector<int> keys{4, 2, 5, 1, 3};
+  typename TestFixture::Heap h1(keys.begin(), keys.end());
+  auto h2 = TestFixture::Heap::from_range(std::vector<int>{9, 7, 8, 6});
+  h1.merge(h2);
+  for (int i = 1; i <= 9; ++i)
+  {
+    ASSERT_EQ(h1.extract_min(), i);
+  }
+  ASSERT_EQ(h1.extract_min(), std::nullopt);
+}
+
+TYPED_TEST(HeapTest, Emplace)
+{
+  typename TestFixture::Heap h{};
+  h.emplace(3);
+  h.emplace();
+  h.emplace(2);
+  h.insert(1);
+  for (int key : {0, 1, 2, 3})
+  {
+    ASSERT_EQ(h.extract_min(), key);
+  }
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TYPED_TEST(HeapTest, Polymorphic)
+{
+  using Heap = typename TestFixture::Heap;
+  static_assert(mergeable_heap<Heap>);
+  static_assert(std::is_final_v<Heap> && !std::is_polymorphic_v<Heap>);
+
+  // the same heap, used only through the virtual interface
+  PolymorphicHeap<Heap> h1{};
+  PolymorphicHeap<Heap> h2{};
+  MergeableHeap<int> &i1 = h1;
+  MergeableHeap<int> &i2 = h2;
+  i1.insert_range(std::vector<int>{5, 3, 9});
+  i2.insert(7);
+  i2.insert(1);
+  i1.merge(i2);
+  i1.sort();
+  ASSERT_EQ(h1.get().minimum(), 1);
+  for (int key : {1, 3, 5, 7, 9})
+  {
+    ASSERT_EQ(i1.extract_min(), key);
+  }
+  ASSERT_EQ(i1.extract_min(), std::nullopt);
+}
+
+TEST(PolymorphicHeapTest, MergeDifferentBackends)
+{
+  PolymorphicHeap<PairingHeap<int>> pairing{};
+  PolymorphicHeap<LeftistHeap<int>> leftist{};
+  MergeableHeap<int> &i1 = pairing;
+  MergeableHeap<int> &i2 = leftist;
+  i2.insert(1);
+  ASSERT_THROW(i1.merge(i2), std::bad_cast);
+  ASSERT_EQ(i2.extract_min(), 1);
+}
+
+/**
+ * @brief A backend whose keys can be ordered by a custom comparator and projection.
+ */
+template <template <typename...> typename H>
+struct Ordered
+{
+  template <typename T, typename Compare, typename Projection = std::identity>
+  using Heap = H<T, Compare, Projection>;
+};
+
+template <typename T>
+class OrderedHeapTest : public ::testing::Test
+{
+protected:
+  template <typename Key, typename Compare, typename Projection = std::identity>
+  using Heap = typename T::template Heap<Key, Compare, Projection>;
+};
+
+using OrderedHeapTypes = ::testing::Types<Ordered<UnsortedLinkedHeap>, Ordered<SortedLinkedHeap>, Ordered<LazyBinomialHeap>>;
+
+TYPED_TEST_SUITE(OrderedHeapTest, OrderedHeapTypes);
+
+TYPED_TEST(OrderedHeapTest, MaxHeap)
+{
+  using Heap = typename TestFixture::template Heap<int, std::greater<>>;
+  static_assert(sizeof(Heap) == sizeof(typename TestFixture::template Heap<int, std::less<>>));
+
+  std::mt19937 rng(20407);
+  std::vector<int> keys(1000);
+  for (int &key : keys)
+  {
+    key = static_cast<int>(rng() % 500);
+  }
+  Heap h1{};
+  Heap h2{};
+  for (std::size_t i = 0; i < keys.size() / 2; ++i)
+  {
+    h1.insert(keys[i]);
+  }
+  h2.insert_range(keys.begin() + keys.size() / 2, keys.end());
+  h1.merge(h2);
+  h1.sort();
+
+  std::sort(keys.begin(), keys.end(), std::greater<>());
+  ASSERT_EQ(h1.minimum(), keys.front());
+  for (int key : keys)
+  {
+    ASSERT_EQ(h1.extract_min(), key);
+  }
+  ASSERT_EQ(h1.extract_min(), std::nullopt);
+}
+
+TYPED_TEST(OrderedHeapTest, StatefulComparator)
+{
+  struct Direction
+  {
+    bool descending;
+    constexpr bool operator()(int a, int b) const { return descending ? b < a : a < b; }
+  };
+  using Heap = typename TestFixture::template Heap<int, Direction>;
+
+  Heap h(Direction{true});
+  h.insert_range(std::vector<int>{3, 1, 4, 1, 5, 9, 2, 6});
+  h.sort(); // the temporary heap must keep the direction
+  ASSERT_TRUE(h.key_comp().descending);
+  for (int key : {9, 6, 5, 4, 3, 2, 1, 1})
+  {
+    ASSERT_EQ(h.extract_min(), key);
+  }
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TYPED_TEST(OrderedHeapTest, Projection)
+{
+  struct Task
+  {
+    int priority;
+    std::string name;
+  };
+  using Heap = typename TestFixture::template Heap<Task, std::less<>, int Task::*>;
+
+  Heap h1(std::less<>(), &Task::priority);
+  Heap h2(std::less<>(), &Task::priority);
+  h1.insert({3, "c"});
+  h1.insert({1, "a"});
+  h2.insert({4, "d"});
+  h2.insert({2, "b"});
+  h1.merge(h2);
+  h1.sort();
+  for (const char *name : {"a", "b", "c", "d"})
+  {
+    ASSERT_EQ(h1.extract_min()->name, name);
+  }
+  ASSERT_FALSE(h1.extract_min().has_value());
+}
+
+template <typename T>
+class MovableHeapTest : public ::testing::Test
+{
+protected:
+  using Heap = T;
+};
+
+using MovableHeapTypes = ::testing::Types<UnsortedLinkedHeap<int>, SortedLinkedHeap<int>, LazyBinomialHeap<int>,
+                                          pmr::UnsortedLinkedHeap<int>, pmr::SortedLinkedHeap<int>, pmr::LazyBinomialHeap<int>>;
+
+TYPED_TEST_SUITE(MovableHeapTest, MovableHeapTypes);
+
+TYPED_TEST(MovableHeapTest, MoveAndSwap)
+{
+  using Heap = typename TestFixture::Heap;
+  using Traits = std::allocator_traits<typename Heap::allocator_type>;
+  static_assert(std::is_nothrow_move_constructible_v<Heap> && std::is_nothrow_swappable_v<Heap>);
+  static_assert(std::is_nothrow_move_assignable_v<Heap> == (Traits::propagate_on_container_move_assignment::value || Traits::is_always_equal::value));
+
+  Heap h1{};
+  h1.insert_range(std::vector<int>{3, 1, 2});
+  Heap h2(std::move(h1));
+  ASSERT_EQ(h1.minimum(), std::nullopt);
+  ASSERT_EQ(h2.minimum(), 1);
+
+  Heap h3{};
+  h3.insert_range(std::vector<int>{5, 4});
+  h3 = std::move(h2); // the keys of h3 are destroyed
+  ASSERT_EQ(h2.minimum(), std::nullopt);
+
+  h1.insert(0);
+  swap(h1, h3);
+  ASSERT_EQ(h3.extract_min(), 0);
+  ASSERT_EQ(h3.extract_min(), std::nullopt);
+  for (int key : {1, 2, 3})
+  {
+    ASSERT_EQ(h1.extract_min(), key);
+  }
+  ASSERT_EQ(h1.extract_min(), std::nullopt);
+
+  // moved-from heaps are empty, but still usable
+  h2.insert(7);
+  ASSERT_EQ(h2.extract_min(), 7);
+}
+
+template <typename T>
+class PmrMovableHeapTest : public ::testing::Test
+{
+protected:
+  using Heap = T;
+};
+
+using PmrMovableHeapTypes = ::testing::Types<pmr::UnsortedLinkedHeap<int>, pmr::SortedLinkedHeap<int>, pmr::LazyBinomialHeap<int>>;
+
+TYPED_TEST_SUITE(PmrMovableHeapTest, PmrMovableHeapTypes);
+
+TYPED_TEST(PmrMovableHeapTest, MoveAssignAcrossResources)
+{
+  // the allocator does not propagate, so the keys must be moved into the target's resource
+  using Heap = typename TestFixture::Heap;
+  std::vector<std::byte> source_buffer(1 << 16);
+  std::vector<std::byte> target_buffer(1 << 16);
+  std::pmr::monotonic_buffer_resource target_resource(target_buffer.data(), target_buffer.size(), std::pmr::null_memory_resource());
+  Heap target(&target_resource);
+  target.insert_range(std::vector<int>{50, 40});
+  {
+    std::pmr::monotonic_buffer_resource source_resource(source_buffer.data(), source_buffer.size(), std::pmr::null_memory_resource());
+    Heap source(&source_resource);
+    source.insert_range(std::vector<int>{8, 6, 7, 5, 3, 0, 9});
+    source.extract_min(); // give the lazy heap some trees
+    target = std::move(source);
+    ASSERT_EQ(source.minimum(), std::nullopt);
+    ASSERT_EQ(target.get_allocator().resource(), &target_resource);
+  }
+  std::ranges::fill(source_buffer, std::byte{0xff}); // nothing may point into the source anymore
+
+  for (int key : {3, 5, 6, 7, 8, 9})
+  {
+    ASSERT_EQ(target.extract_min(), key);
+  }
+  ASSERT_EQ(target.extract_min(), std::nullopt);
+}
+
+TYPED_TEST(PmrMovableHeapTest, SwapAcrossResources)
+{
+  using Heap = typename TestFixture::Heap;
+  std::pmr::monotonic_buffer_resource r1;
+  std::pmr::monotonic_buffer_resource r2;
+  Heap h1(&r1);
+  Heap h2(&r2);
+  h1.insert(1);
+  h2.insert(2);
+  EXPECT_DEBUG_DEATH(swap(h1, h2), "");
+}
+
+TYPED_TEST(MovableHeapTest, Vector)
+{
+  // the heaps are moved whenever the vector grows
+  std::vector<typename TestFixture::Heap> heaps;
+  for (int i = 0; i < 1000; ++i)
+  {
+    heaps.emplace_back().insert_range(std::vector<int>{i + 2, i, i + 1});
+  }
+  heaps.erase(heaps.begin(), heaps.begin() + 500);
+  for (int i = 0; i < 500; ++i)
+  {
+    for (int key : {i + 500, i + 501, i + 502})
+    {
+      ASSERT_EQ(heaps[i].extract_min(), key);
+    }
+    ASSERT_EQ(heaps[i].extract_min(), std::nullopt);
+  }
+}
+
+TYPED_TEST(OrderedHeapTest, Handles)
+{
+  struct Job
+  {
+    int priority;
+    int id;
+  };
+  using Heap = typename TestFixture::template Heap<Job, std::less<>, int Job::*>;
+
+  // reprioritize and cancel queued jobs through their handles
+  Heap h(std::less<>(), &Job::priority);
+  std::vector<typename Heap::handle_type> jobs;
+  for (int id = 0; id < 6; ++id)
+  {
+    jobs.push_back(h.push({10 + id, id}));
+  }
+  h.decrease_key(jobs[4], {1, 4});
+  h.decrease_key(jobs[5], {12, 5}); // ties with job 2
+  ASSERT_EQ(h.erase(jobs[0]).id, 0);
+  ASSERT_EQ(h.erase(jobs[3]).id, 3);
+  ASSERT_THROW(h.decrease_key(jobs[1], {20, 1}), std::invalid_argument);
+
+  ASSERT_EQ(h.extract_min()->id, 4);
+  ASSERT_EQ(h.extract_min()->id, 1);
+  ASSERT_EQ(h.extract_min()->priority, 12);
+  ASSERT_EQ(h.extract_min()->priority, 12);
+  ASSERT_FALSE(h.extract_min().has_value());
+}
+
+template <typename T>
+class HandleHeapTest : public ::testing::Test
+{
+protected:
+  using Heap = T;
+};
+
+using HandleHeapTypes = ::testing::Types<UnsortedLinkedHeap<int>, SortedLinkedHeap<int>, LazyBinomialHeap<int>,
+                                         pmr::UnsortedLinkedHeap<int>, pmr::SortedLinkedHeap<int>, pmr::LazyBinomialHeap<int>>;
+
+TYPED_TEST_SUITE(HandleHeapTest, HandleHeapTypes);
+
+TYPED_TEST(HandleHeapTest, DecreaseKeyAndErase)
+{
+  // random pushes, extractions, decreases and erasures, checked against a sorted multiset
+  using Heap = typename TestFixture::Heap;
+  std::mt19937 rng(20407);
+  Heap h{};
+  std::vector<typename Heap::handle_type> handles;
+  std::multiset<int> expected;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const unsigned op = rng() % 8;
+    if (op < 3 || handles.empty())
+    {
+      const int key = static_cast<int>(rng() % 100000);
+      handles.push_back(h.push(key));
+      expected.insert(key);
+    }
+    else if (op < 6)
+    {
+      const std::size_t i = rng() % handles.size();
+      const int key = *handles[i];
+      const int new_key = key - static_cast<int>(rng() % 1000);
+      h.decrease_key(handles[i], new_key);
+      expected.erase(expected.find(key));
+      expected.insert(new_key);
+      ASSERT_EQ(*handles[i], new_key);
+    }
+    else if (op < 7)
+    {
+      const std::size_t i = rng() % handles.size();
+      const int key = *handles[i];
+      ASSERT_EQ(h.erase(handles[i]), key);
+      expected.erase(expected.find(key));
+      handles[i] = handles.back();
+      handles.pop_back();
+    }
+    else
+    {
+      const int key = h.minimum()->get();
+      ASSERT_EQ(key, *expected.begin());
+      // the minimum key may be held by any of the handles with that key
+      auto it = std::find_if(handles.begin(), handles.end(), [&](auto handle)
+                             { return &*handle == &h.minimum()->get(); });
+      ASSERT_NE(it, handles.end());
+      ASSERT_EQ(h.extract_min(), key);
+      expected.erase(expected.begin());
+      *it = handles.back();
+      handles.pop_back();
+    }
+    ASSERT_EQ(h.minimum().has_value(), !expected.empty());
+    if (!expected.empty())
+    {
+      ASSERT_EQ(h.minimum()->get(), *expected.begin());
+    }
+  }
+}
+
+TYPED_TEST(HandleHeapTest, HandlesSurviveMergeAndMove)
+{
+  using Heap = typename TestFixture::Heap;
+  Heap h1{};
+  Heap h2{};
+  h1.push(10);
+  auto deep = h1.push(20);
+  h1.push(30);
+  h1.extract_min(); // consolidate, so a key has a parent
+  auto handle = h2.emplace(40);
+  h2.push(50);
+  h1.merge(h2);
+  h1.decrease_key(handle, 1);
+  Heap h3(std::move(h1));
+  ASSERT_EQ(h3.erase(deep), 20);
+  ASSERT_EQ(h3.extract_min(), 1);
+  ASSERT_EQ(h3.extract_min(), 30);
+  ASSERT_THROW(h3.decrease_key(h3.push(60), 70), std::invalid_argument);
+  ASSERT_EQ(h3.extract_min(), 50);
+  ASSERT_EQ(h3.extract_min(), 60);
+  ASSERT_EQ(h3.extract_min(), std::nullopt);
+}
+
+/**
+ * @brief A key that counts how many times it has been moved.
+ */
+struct Counted
+{
+  inline static int moves = 0; ///< The number of moves of any key so far.
+
+  int priority;     ///< The value the keys are ordered by.
+  std::string name; ///< A payload that is expensive to copy.
+
+  Counted(int priority, std::string name) : priority(priority), name(std::move(name)) {}
+  Counted(Counted &&other) noexcept : priority(other.priority), name(std::move(other.name)) { ++moves; }
+  Counted &operator=(Counted &&other) noexcept
+  {
+    priority = other.priority;
+    name = std::move(other.name);
+    ++moves;
+    return *this;
+  }
+
+  friend bool operator<(const Counted &a, const Counted &b) { return a.priority < b.priority; }
+};
+
+template <typename T>
+class EmplaceHeapTest : public ::testing::Test
+{
+protected:
+  using Heap = T;
+};
+
+using EmplaceHeapTypes = ::testing::Types<UnsortedLinkedHeap<Counted>, SortedLinkedHeap<Counted>, LazyBinomialHeap<Counted>,
+                                          EagerBinomialHeap<Counted>, PairingHeap<Counted>, LeftistHeap<Counted>>;
+
+TYPED_TEST_SUITE(EmplaceHeapTest, EmplaceHeapTypes);
+
+TYPED_TEST(EmplaceHeapTest, ConstructsInPlace)
+{
+  typename TestFixture::Heap h{};
+  Counted::moves = 0;
+  h.emplace(2, "two");
+  h.emplace(1, std::string(100, 'x'));
+  ASSERT_EQ(Counted::moves, 0);
+  h.insert(Counted(0, "zero"));
+  ASSERT_EQ(Counted::moves, 1); // from the argument into the node
+
+  std::optional<Counted> key = h.extract_min();
+  ASSERT_EQ(key->name, "zero");
+  key = h.extract_min();
+  ASSERT_EQ(key->name, std::string(100, 'x'));
+  key = h.extract_min();
+  ASSERT_EQ(key->name, "two");
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+template <typename T>
+class PmrHeapTest : public ::testing::Test
+{
+protected:
+  using Heap = T;
+};
+
+using PmrHeapTypes = ::testing::Types<pmr::UnsortedLinkedHeap<int>, pmr::SortedLinkedHeap<int>, pmr::LazyBinomialHeap<int>,
+                                      pmr::CompactUnsortedHeap<int>, pmr::ChunkedUnsortedHeap<int>, pmr::PairingHeap<int>,
+                                      pmr::ArrayDaryHeap<int>, pmr::LeftistHeap<int>,
+                                      pmr::EagerBinomialHeap<int>, pmr::MinMaxHeap<int>, pmr::BucketQueue<int, 1024>,
+                                      pmr::SoftHeap<int>, pmr::BHeap<int, 256>>;
+
+TYPED_TEST_SUITE(PmrHeapTest, PmrHeapTypes);
+
+TYPED_TEST(PmrHeapTest, MonotonicBuffer)
+{
+  // the upstream resource throws, so every node must come from the buffer
+  std::array<std::byte, 1 << 16> buffer;
+  std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+  typename TestFixture::Heap h1(&resource);
+  typename TestFixture::Heap h2(&resource);
+  for (int i = 100; i > 0; --i)
+  {
+    h1.insert(i);
+    h2.insert(i + 100);
+  }
+  h1.merge(h2);
+  h1.sort();
+  for (int i = 1; i <= 200; ++i)
+  {
+    ASSERT_EQ(h1.extract_min(), i);
+  }
+  ASSERT_EQ(h1.extract_min(), std::nullopt);
+  ASSERT_EQ(h1.get_allocator().resource(), &resource);
+}
+
+TYPED_TEST(PmrHeapTest, InsertRangeBuffer)
+{
+  // the bulk-load buffer comes from the heap's memory resource, not from the global heap
+  std::vector<std::byte> buffer(1 << 20);
+  std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i)
+  {
+    keys[i] = (i * 7919) % 1000;
+  }
+
+  typename TestFixture::Heap h(&resource);
+  PolymorphicHeap<typename TestFixture::Heap> p(&resource);
+  MergeableHeap<int> &i = p;
+  const std::size_t before = allocations;
+  h.insert_range(keys);
+  i.insert_range(keys);
+  ASSERT_EQ(allocations, before);
+
+  h.merge(p.get());
+  for (int key = 0; key < 1000; ++key)
+  {
+    ASSERT_EQ(h.extract_min(), key);
+    ASSERT_EQ(h.extract_min(), key);
+  }
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+/**
+ * @brief A memory resource that counts the allocations it forwards to its upstream.
+ */
+class CountingResource final : public std::pmr::memory_resource
+{
+public:
+  std::size_t allocations = 0; ///< The number of allocations made so far.
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+TYPED_TEST(PmrHeapTest, InsertRangeThroughInterface)
+{
+  // the batch collected by the interface is handed to the wrapped heap without a second copy
+  const std::vector<int> keys{8, 6, 7, 5, 3, 0, 9};
+  CountingResource direct_resource;
+  CountingResource interface_resource;
+  typename TestFixture::Heap h(&direct_resource);
+  PolymorphicHeap<typename TestFixture::Heap> p(&interface_resource);
+  MergeableHeap<int> &i = p;
+  h.insert_range(keys);
+  i.insert_range(keys);
+  ASSERT_EQ(interface_resource.allocations, direct_resource.allocations);
+}
+
+TEST(LazyBinomialHeapTest, DestroyLargeRootList)
+{
+  // a million unconsolidated inserts used to be destroyed recursively
+  LazyBinomialHeap<std::string> h{};
+  for (int i = 0; i < 1'000'000; ++i)
+  {
+    h.insert(std::to_string(i));
+  }
+  h.extract_min(); // consolidate into deep trees as well
+  for (int i = 0; i < 1'000'000; ++i)
+  {
+    h.insert(std::to_string(i));
+  }
+}
+
+TEST(LazyBinomialHeapTest, ExtractMinDoesNotAllocate)
+{
+  LazyBinomialHeap<int> h{};
+  for (int i = 10000; i > 0; --i)
+  {
+    h.insert(i);
+  }
+
+  const std::size_t allocations_before = allocations;
+  for (int i = 1; i <= 10000; ++i)
+  {
+    ASSERT_EQ(h.extract_min(), i);
+  }
+  ASSERT_EQ(allocations, allocations_before);
+}
+
+TEST(LazyBinomialHeapTest, Clear)
+{
+  LazyBinomialHeap<int> h{};
+  for (int i = 0; i < 1000; ++i)
+  {
+    h.insert(i);
+  }
+  h.extract_min();
+  h.clear();
+  ASSERT_EQ(h.minimum(), std::nullopt);
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+
+  h.insert(3);
+  h.insert(1);
+  h.insert(2);
+  ASSERT_EQ(h.extract_min(), 1);
+  ASSERT_EQ(h.extract_min(), 2);
+  ASSERT_EQ(h.extract_min(), 3);
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TEST(LazyBinomialHeapTest, ThrowingComparator)
+{
+  // an exception thrown while linking trees reaches the caller instead of std::terminate
+  struct Less
+  {
+    const bool *fail;
+    bool operator()(int a, int b) const
+    {
+      if (*fail)
+      {
+        throw std::runtime_error("comparison failed");
+      }
+      return a < b;
+    }
+  };
+
+  bool fail = false;
+  LazyBinomialHeap<int, Less> h(Less{&fail});
+  for (int i = 0; i < 8; ++i)
+  {
+    h.insert(i);
+  }
+  fail = true;
+  ASSERT_THROW(h.extract_min(), std::runtime_error);
+}
+
+TEST(PairingHeapTest, DestroyDeepTree)
+{
+  // ascending inserts followed by a single extraction leave a path-like tree behind
+  PairingHeap<std::string> h{};
+  for (int i = 0; i < 1'000'000; ++i)
+  {
+    h.insert(std::to_string(i));
+  }
+  h.extract_min();
+}
+
+TEST(FibonacciHeapTest, DecreaseKeyAndErase)
+{
+  // random pushes, extractions, decreases and erasures, checked against a sorted multiset
+  static_assert(std::is_same_v<FibonacciHeap<int>, LazyBinomialHeap<int>>);
+  std::mt19937 rng(20407);
+  FibonacciHeap<int> h{};
+  std::vector<FibonacciHeap<int>::handle_type> handles;
+  std::multiset<int> expected;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const unsigned op = rng() % 8;
+    if (op < 3 || handles.empty())
+    {
+      const int key = static_cast<int>(rng() % 100000);
+      handles.push_back(h.push(key));
+      expected.insert(key);
+    }
+    else if (op < 6)
+    {
+      const std::size_t i = rng() % handles.size();
+      const int key = *handles[i];
+      const int new_key = key - static_cast<int>(rng() % 1000);
+      h.decrease_key(handles[i], new_key);
+      expected.erase(expected.find(key));
+      expected.insert(new_key);
+      ASSERT_EQ(*handles[i], new_key);
+    }
+    else if (op < 7)
+    {
+      const std::size_t i = rng() % handles.size();
+      const int key = *handles[i];
+      ASSERT_EQ(h.erase(handles[i]), key);
+      expected.erase(expected.find(key));
+      handles[i] = handles.back();
+      handles.pop_back();
+    }
+    else
+    {
+      const int key = h.minimum()->get();
+      ASSERT_EQ(key, *expected.begin());
+      // the minimum key may be held by any of the handles with that key
+      auto it = std::find_if(handles.begin(), handles.end(), [&](auto handle)
+                             { return &*handle == &h.minimum()->get(); });
+      ASSERT_NE(it, handles.end());
+      ASSERT_EQ(h.extract_min(), key);
+      expected.erase(expected.begin());
+      *it = handles.back();
+      handles.pop_back();
+    }
+    ASSERT_EQ(h.minimum().has_value(), !expected.empty());
+    if (!expected.empty())
+    {
+      ASSERT_EQ(h.minimum()->get(), *expected.begin());
+    }
+  }
+}
+
+TEST(FibonacciHeapTest, HandlesSurviveMerge)
+{
+  FibonacciHeap<int> h1{};
+  FibonacciHeap<int> h2{};
+  h1.push(10);
+  h1.push(20);
+  h1.extract_min(); // consolidate, so 20 has a parent
+  h1.push(5);
+  auto handle = h2.push(30);
+  h2.push(40);
+  h1.merge(h2);
+  h1.decrease_key(handle, 1);
+  ASSERT_EQ(h1.extract_min(), 1);
+  ASSERT_EQ(h1.extract_min(), 5);
+  ASSERT_THROW(h1.decrease_key(h1.push(50), 60), std::invalid_argument);
+}
+
+TEST(RadixHeapTest, MonotoneWorkload)
+{
+  // Dijkstra-like: every inserted key is at least the last extracted minimum
+  std::mt19937 rng(20407);
+  RadixHeap<std::uint32_t> h{};
+  std::multiset<std::uint32_t> expected;
+  std::uint32_t last = 0;
+  for (int i = 0; i < 20000; ++i)
+  {
+    if (rng() % 3 != 0 || expected.empty())
+    {
+      const std::uint32_t key = last + rng() % (1u << (rng() % 32));
+      h.insert(key);
+      expected.insert(key);
+    }
+    else
+    {
+      last = *expected.begin();
+      ASSERT_EQ(h.minimum()->get(), last);
+      ASSERT_EQ(h.extract_min(), last);
+      expected.erase(expected.begin());
+    }
+  }
+  while (!expected.empty())
+  {
+    ASSERT_EQ(h.extract_min(), *expected.begin());
+    expected.erase(expected.begin());
+  }
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TEST(RadixHeapTest, RejectsKeysBelowLastMinimum)
+{
+  RadixHeap<std::uint64_t> h{};
+  h.insert(10);
+  h.insert(20);
+  ASSERT_EQ(h.extract_min(), 10u);
+  ASSERT_THROW(h.insert(9), std::invalid_argument);
+  h.insert(10);
+  ASSERT_EQ(h.extract_min(), 10u);
+  ASSERT_EQ(h.extract_min(), 20u);
+}
+
+TEST(RadixHeapTest, MergeLowersLastMinimum)
+{
+  RadixHeap<std::uint32_t> h1{};
+  RadixHeap<std::uint32_t> h2{};
+  for (std::uint32_t key : {100u, 200u, 300u})
+  {
+    h1.insert(key);
+  }
+  ASSERT_EQ(h1.extract_min(), 100u);
+  h2.insert(5);
+  h2.insert(150);
+  h1.merge(h2);
+  ASSERT_EQ(h2.extract_min(), std::nullopt);
+  for (std::uint32_t key : {5u, 150u, 200u, 300u})
+  {
+    ASSERT_EQ(h1.extract_min(), key);
+  }
+}
+
+TEST(BucketQueueTest, SmallPriorities)
+{
+  // many duplicates of few priorities, checked against a sorted multiset
+  std::mt19937 rng(20407);
+  BucketQueue<int, 300> h1{};
+  BucketQueue<int, 300> h2{};
+  std::multiset<int> expected;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int key = static_cast<int>(rng() % 300);
+    if (rng() % 4 == 0)
+    {
+      h2.insert(key);
+    }
+    else
+    {
+      h1.insert(key);
+    }
+    expected.insert(key);
+    if (rng() % 3 == 0)
+    {
+      h1.merge(h2);
+      ASSERT_EQ(h1.extract_min(), *expected.begin());
+      expected.erase(expected.begin());
+    }
+  }
+  h1.merge(h2);
+  while (!expected.empty())
+  {
+    ASSERT_EQ(h1.minimum()->get(), *expected.begin());
+    ASSERT_EQ(h1.extract_min(), *expected.begin());
+    expected.erase(expected.begin());
+  }
+  ASSERT_EQ(h1.extract_min(), std::nullopt);
+}
+
+TEST(BucketQueueTest, RejectsKeysOutOfRange)
+{
+  BucketQueue<int, 100> h{};
+  ASSERT_THROW(h.insert(-1), std::out_of_range);
+  ASSERT_THROW(h.insert(100), std::out_of_range);
+  h.insert(99);
+  h.insert(0);
+  ASSERT_EQ(h.extract_min(), 0);
+  ASSERT_EQ(h.extract_min(), 99);
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TEST(SoftHeapTest, CorruptionIsBounded)
+{
+  // every key comes out exactly once, and at most ε n keys are corrupted at any time
+  std::mt19937 rng(20407);
+  constexpr double epsilon = 0.1;
+  SoftHeap<int> h1(epsilon);
+  SoftHeap<int> h2(epsilon);
+  std::multiset<int> inserted;
+  std::multiset<int> extracted;
+  std::size_t max_corrupted = 0;
+  for (int i = 0; i < 100000; ++i)
+  {
+    const int key = static_cast<int>(rng() % 100000);
+    (rng() % 4 == 0 ? h2 : h1).insert(key);
+    inserted.insert(key);
+    if (rng() % 3 == 0)
+    {
+      h1.merge(h2);
+      ASSERT_EQ(h2.corrupted(), 0u);
+      extracted.insert(*h1.extract_min());
+    }
+    ASSERT_LE(h1.corrupted() + h2.corrupted(), epsilon * static_cast<double>(inserted.size()));
+    max_corrupted = std::max(max_corrupted, h1.corrupted() + h2.corrupted());
+  }
+  h1.merge(h2);
+  while (auto key = h1.extract_min())
+  {
+    extracted.insert(*key);
+  }
+  ASSERT_EQ(h1.corrupted(), 0u);
+  ASSERT_EQ(extracted, inserted);
+  ASSERT_GT(max_corrupted, 0u); // the keys did travel in groups
+}
+
+TEST(SoftHeapTest, RejectsInvalidErrorRate)
+{
+  ASSERT_THROW(SoftHeap<int>(-0.1), std::invalid_argument);
+  ASSERT_THROW(SoftHeap<int>(1.5), std::invalid_argument);
+  SoftHeap<int> h(1.0);
+  ASSERT_EQ(h.error_rate(), 1.0);
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TEST(ArrayDaryHeapTest, CacheLineAligned)
+{
+  // the resource hands out memory aligned to 4 bytes only, but the children still share a cache line
+  alignas(64) std::array<std::byte, 1 << 12> buffer;
+  std::pmr::monotonic_buffer_resource resource(buffer.data() + sizeof(int), buffer.size() - sizeof(int), std::pmr::null_memory_resource());
+  pmr::ArrayDaryHeap<int, 4> h(&resource);
+  for (int i = 100; i > 0; --i)
+  {
+    h.insert(i);
+  }
+  // the root follows D - 1 unused slots, so its children start at a cache line
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&h.minimum()->get()) % 64, 3 * sizeof(int));
+  for (int i = 1; i <= 100; ++i)
+  {
+    ASSERT_EQ(h.extract_min(), i);
+  }
+}
+
+TEST(BHeapTest, SmallPages)
+{
+  // three keys per page, so paths cross many pages, checked against a sorted multiset
+  std::mt19937 rng(20407);
+  BHeap<std::string, 4 * sizeof(std::string)> h1{};
+  BHeap<std::string, 4 * sizeof(std::string)> h2{};
+  std::multiset<std::string> expected;
+  std::multiset<std::string> pending; // the keys in h2
+  for (int i = 0; i < 20000; ++i)
+  {
+    const std::string key = std::to_string(rng() % 100000);
+    const bool second = rng() % 4 == 0;
+    (second ? h2 : h1).insert(key);
+    (second ? pending : expected).insert(key);
+    if (rng() % 3 == 0 && !expected.empty())
+    {
+      ASSERT_EQ(h1.extract_min(), *expected.begin());
+      expected.erase(expected.begin());
+    }
+    if (rng() % 1000 == 0)
+    {
+      h1.merge(h2);
+      expected.merge(pending);
+    }
+  }
+  h1.merge(h2);
+  expected.merge(pending);
+  while (!expected.empty())
+  {
+    ASSERT_EQ(h1.minimum()->get(), *expected.begin());
+    ASSERT_EQ(h1.extract_min(), *expected.begin());
+    expected.erase(expected.begin());
+  }
+  ASSERT_EQ(h1.extract_min(), std::nullopt);
+}
+
+TEST(ChunkedUnsortedHeapTest, ChunksStayDense)
+{
+  // 63 small keys and 1 huge key per chunk; extracting the small keys leaves 1 key per chunk
+  // unless the chunks are joined
+  constexpr std::size_t B = 64;
+  constexpr int chunks = 100;
+  ChunkedUnsortedHeap<int, B> h{};
+  for (int c = 0; c < chunks; ++c)
+  {
+    for (int i = 0; i < 63; ++i)
+    {
+      h.insert(c * 63 + i);
+    }
+    h.insert(1'000'000 + c);
+  }
+  for (int i = 0; i < chunks * 63; ++i)
+  {
+    ASSERT_EQ(h.extract_min(), i);
+  }
+  ASSERT_LE(h.chunks(), 2 * chunks / B + 1);
+
+  // merging many small heaps joins the partial chunks at the seams
+  ChunkedUnsortedHeap<int, B> merged{};
+  for (int i = 0; i < 1000; ++i)
+  {
+    ChunkedUnsortedHeap<int, B> single{};
+    single.insert(1000 - i);
+    merged.merge(single);
+  }
+  ASSERT_LE(merged.chunks(), 2 * 1000 / B + 1);
+  h.merge(merged);
+  ASSERT_LE(h.chunks(), 2 * (chunks + 1000) / B + 1);
+  for (int i = 1; i <= 1000; ++i)
+  {
+    ASSERT_EQ(h.extract_min(), i);
+  }
+  for (int c = 0; c < chunks; ++c)
+  {
+    ASSERT_EQ(h.extract_min(), 1'000'000 + c);
+    ASSERT_LE(h.chunks(), 2 * (chunks - c - 1) / B + 1);
+  }
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+TEST(MinMaxHeapTest, DoubleEnded)
+{
+  // random insertions, merges and extractions from both ends, checked against a sorted multiset
+  std::mt19937 rng(20407);
+  MinMaxHeap<int> h{};
+  std::multiset<int> expected;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const unsigned op = rng() % 8;
+    if (op < 3)
+    {
+      const int key = static_cast<int>(rng() % 1000);
+      h.insert(key);
+      expected.insert(key);
+    }
+    else if (op < 4)
+    {
+      MinMaxHeap<int> other{};
+      for (unsigned j = rng() % 50; j > 0; --j)
+      {
+        const int key = static_cast<int>(rng() % 1000);
+        other.insert(key);
+        expected.insert(key);
+      }
+      h.merge(other);
+      ASSERT_EQ(other.minimum(), std::nullopt);
+    }
+    else if (op < 6)
+    {
+      ASSERT_EQ(h.extract_min(), expected.empty() ? std::nullopt : std::optional(*expected.begin()));
+      if (!expected.empty())
+      {
+        expected.erase(expected.begin());
+      }
+    }
+    else
+    {
+      ASSERT_EQ(h.extract_max(), expected.empty() ? std::nullopt : std::optional(*expected.rbegin()));
+      if (!expected.empty())
+      {
+        expected.erase(std::prev(expected.end()));
+      }
+    }
+    if (!expected.empty())
+    {
+      ASSERT_EQ(h.minimum()->get(), *expected.begin());
+      ASSERT_EQ(h.maximum()->get(), *expected.rbegin());
+    }
+  }
+}
+
+TEST(MinMaxHeapTest, BoundedQueue)
+{
+  // keep the 5 smallest keys, evicting the largest one whenever the queue overflows
+  PolymorphicDoubleEndedHeap<MinMaxHeap<int>> heap{};
+  DoubleEndedMergeableHeap<int> &h = heap;
+  std::size_t size = 0;
+  for (int key : {50, 20, 80, 10, 90, 30, 70, 40, 60, 0})
+  {
+    h.insert(key);
+    if (++size > 5)
+    {
+      h.extract_max();
+      --size;
+    }
+  }
+  for (int key : {0, 10, 20, 30, 40})
+  {
+    ASSERT_EQ(h.extract_min(), key);
+  }
+  ASSERT_EQ(h.extract_min(), std::nullopt);
+}
+
+template <typename T>
+class ArgminTest : public ::testing::Test
+{
+};
+
+using ArgminTypes = ::testing::Types<std::int32_t, std::int64_t, float, double>;
+
+TYPED_TEST_SUITE(ArgminTest, ArgminTypes);
+
+TYPED_TEST(ArgminTest, MatchesScalar)
+{
+  std::mt19937 rng(20407);
+  for (std::size_t count = 1; count <= 200; ++count)
+  {
+    std::vector<TypeParam> keys(count);
+    for (auto &key : keys)
+    {
+      key = static_cast<TypeParam>(static_cast<int>(rng() % 64) - 32); // plenty of duplicates
+    }
+    const std::size_t expected = simd::argmin_scalar(keys.data(), count);
+    ASSERT_EQ(simd::argmin(keys.data(), count), expected);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (__builtin_cpu_supports("avx2"))
+    {
+      ASSERT_EQ(simd::detail::argmin_avx2(keys.data(), count), expected);
+    }
+    if constexpr (std::is_same_v<TypeParam, std::int64_t>)
+    {
+      if (__builtin_cpu_supports("sse4.2"))
+      {
+        ASSERT_EQ(simd::detail::argmin_sse42(keys.data(), count), expected);
+      }
+    }
+    else if (__builtin_cpu_supports("sse4.1"))
+    {
+      ASSERT_EQ(simd::detail::argmin_sse41(keys.data(), count), expected);
+    }
+#endif
+  }
+}
+
+TEST(ArgminTest, ConstantEvaluated)
+{
+  constexpr int keys[] = {5, 3, 8, 3, 9};
+  static_assert(simd::argmin(keys, 5) == 1);
+}
+
+TEST(ArgminTest, NoMacroLeak)
+{
+#ifdef SIMD_X86_AVAILABLE
+  FAIL() << "simd.h leaks SIMD_X86_AVAILABLE";
+#endif
+}
+
+TEST(LoaderTest, NextLine)
+{
+  std::string_view text = "1 2\r\n\n3";
+  EXPECT_EQ(next_line(text), "1 2\r");
+  EXPECT_EQ(next_line(text), "");
+  EXPECT_EQ(next_line(text), "3");
+  EXPECT_EQ(next_line(text), std::nullopt);
+}
+
+TEST(LoaderTest, ParseIntegers)
+{
+  EXPECT_EQ(parse_integers("  5 -3\t+8  2147483647 -2147483648\r"), (std::vector<int>{5, -3, 8, 2147483647, -2147483648}));
+  EXPECT_TRUE(parse_integers("").empty());
+  EXPECT_THROW(parse_integers("1 two 3"), std::runtime_error);
+  EXPECT_THROW(parse_integers("12abc"), std::runtime_error);
+  EXPECT_THROW(parse_integers("2147483648"), std::runtime_error);
+  EXPECT_THROW(parse_integers("+-5"), std::runtime_error);
+  EXPECT_THROW(parse_integers("1 + 2"), std::runtime_error);
+  EXPECT_THROW(parse_integers("++5"), std::runtime_error);
+}
+
+TEST(LoaderTest, NoMacroLeak)
+{
+#ifdef MMAP_AVAILABLE
+  FAIL() << "loader.h leaks MMAP_AVAILABLE";
+#endif
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
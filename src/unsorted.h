@@ -1,9 +1,14 @@
 #ifndef UNSORTED_HEAP_H
 #define UNSORTED_HEAP_H
 
+#include <cassert>
 #include <optional>
+#include <stdexcept>
 #include <functional>
 #include <type_traits>
+#include <memory>
+#include <utility>
+#include <memory_resource>
 
 #include "mergeable_heap.h"
 
@@ -16,12 +21,26 @@
  * maintained in an unsorted order, with pointers to the tail and the minimum nodes in
  * the list to allow for constant time insertion, merge and extraction of the minimum key.
  *
+ * `push` returns a handle to the inserted key, which can later be used to decrease the key
+ * with `decrease_key`, or to remove it with `erase`. Both take O(1) time, as the list is
+ * doubly linked, unless the minimum itself is erased, which requires a new O(n) search.
+ *
  * @tparam T The type of the elements stored in the heap. `T` must be movable, as it is
- * moved into the heap in the insert method.
+ * moved into the heap in the insert method, and move-assignable, as it is reassigned in
+ * the decrease_key method.
+ * @tparam Compare The strict weak ordering of the projected keys. A stateless comparator
+ * takes no space in the heap.
+ * @tparam Projection The projection applied to the keys before they are compared.
+ * @tparam Allocator The allocator used to allocate the nodes of the heap. It is rebound
+ * to the node type, so a `std::pmr::polymorphic_allocator` keeps all nodes of a heap in
+ * the memory resource it was given.
  */
-template <typename T>
-class UnsortedLinkedHeap : public MergeableHeap<T>
+template <typename T, typename Compare = std::less<>, typename Projection = std::identity, typename Allocator = std::allocator<T>>
+class UnsortedLinkedHeap final : public MergeableHeapBase<UnsortedLinkedHeap<T, Compare, Projection, Allocator>, T, Compare, Projection>
 {
+  using Base = MergeableHeapBase<UnsortedLinkedHeap, T, Compare, Projection>; ///< The non-virtual base of the heap.
+  friend Base;
+
 private:
   struct Node
   {
@@ -30,11 +49,12 @@ private:
     Node *prev; ///< A pointer to the previous node in the linked list.
 
     /**
-     * @brief Constructs a new node with the given key.
+     * @brief Constructs a new node whose key is constructed in place from the given arguments.
      *
-     * @param key The key to store in the node. This key is moved into the node.
+     * @param args The arguments forwarded to the constructor of the key.
      */
-    constexpr Node(T key) : key(std::move(key)), next(nullptr), prev(nullptr) {}
+    template <typename... Args>
+    constexpr explicit Node(std::in_place_t, Args &&...args) : key(std::forward<Args>(args)...), next(nullptr), prev(nullptr) {}
 
     /**
      * @brief Default destructor.
@@ -44,6 +64,54 @@ private:
     constexpr ~Node() = default;
   };
 
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+public:
+  using allocator_type = Allocator;
+
+  /**
+   * @class handle_type
+   * @brief A handle to a key in the heap.
+   *
+   * A handle is returned by `push` and `emplace`, and stays valid until its key is extracted
+   * or erased, or the heap is sorted or destroyed. Merging a heap into another keeps its handles
+   * valid; they then refer to keys of the heap that was merged into.
+   */
+  class handle_type
+  {
+  public:
+    /**
+     * @brief Constructs a handle that does not refer to any key.
+     */
+    constexpr handle_type() noexcept = default;
+
+    /**
+     * @brief Returns the key the handle refers to.
+     */
+    constexpr const T &operator*() const noexcept
+    {
+      return node->key;
+    }
+
+    /**
+     * @brief Accesses the key the handle refers to.
+     */
+    constexpr const T *operator->() const noexcept
+    {
+      return &node->key;
+    }
+
+    constexpr bool operator==(const handle_type &) const noexcept = default;
+
+  private:
+    friend class UnsortedLinkedHeap;
+
+    constexpr explicit handle_type(Node *node) noexcept : node(node) {}
+
+    Node *node = nullptr; ///< The node holding the key.
+  };
+
 private:
   /**
    * @brief Constructs a new heap with the given key.
@@ -51,8 +119,14 @@ private:
    * The time complexity of this operation is O(1).
    *
    * @param key The key to store in the heap. This key is moved into the heap.
+   * @param comp The comparator used to order the keys.
+   * @param proj The projection applied to the keys before they are compared.
+   * @param alloc The allocator used to allocate the nodes of the heap.
    */
-  constexpr UnsortedLinkedHeap(T key) : head(new Node(std::move(key))), tail(head), min(head) {}
+  constexpr UnsortedLinkedHeap(T key, const Compare &comp, const Projection &proj, const Allocator &alloc) : UnsortedLinkedHeap(comp, proj, alloc)
+  {
+    head = tail = min = create_node(std::move(key));
+  }
 
 public:
   /**
@@ -63,7 +137,57 @@ public:
    *
    * The time complexity of this operation is O(1).
    */
-  constexpr UnsortedLinkedHeap() : head(nullptr), tail(nullptr), min(nullptr) {}
+  constexpr UnsortedLinkedHeap() : UnsortedLinkedHeap(Allocator()) {}
+
+  /**
+   * @brief Constructs a new empty heap that allocates its nodes using the given allocator.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit UnsortedLinkedHeap(const Allocator &alloc) : UnsortedLinkedHeap(Compare(), Projection(), alloc) {}
+
+  /**
+   * @brief Constructs a new empty heap that orders its keys using the given comparator and
+   * projection.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param comp The comparator used to order the keys.
+   * @param proj The projection applied to the keys before they are compared.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  constexpr explicit UnsortedLinkedHeap(const Compare &comp, const Projection &proj = Projection(), const Allocator &alloc = Allocator())
+      : comp(comp), proj(proj), alloc(alloc), head(nullptr), tail(nullptr), min(nullptr) {}
+
+  /**
+   * @brief Constructs a new heap holding the keys in the range [first, last).
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   *
+   * @param first The beginning of the range of keys.
+   * @param last The end of the range of keys.
+   * @param alloc The allocator used to allocate the nodes of the heap.
+   */
+  template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+  constexpr UnsortedLinkedHeap(Iterator first, Sentinel last, const Allocator &alloc = Allocator()) : UnsortedLinkedHeap(alloc)
+  {
+    this->insert_range(std::move(first), std::move(last));
+  }
+
+  /**
+   * @brief Returns a new heap holding the keys of the given range.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys in
+   * the range.
+   */
+  template <std::ranges::input_range Range>
+  static constexpr UnsortedLinkedHeap from_range(Range &&range, const Allocator &alloc = Allocator())
+  {
+    return UnsortedLinkedHeap(std::ranges::begin(range), std::ranges::end(range), alloc);
+  }
 
   /**
    * @brief Destroys the heap.
@@ -75,16 +199,114 @@ public:
    */
   constexpr ~UnsortedLinkedHeap()
   {
-    for (Node *current = head; current != nullptr;)
+    destroy_list(head);
+  }
+
+  /**
+   * @brief Constructs a new heap that takes over the nodes of another heap.
+   *
+   * @note The other heap is left empty.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to move from.
+   */
+  constexpr UnsortedLinkedHeap(UnsortedLinkedHeap &&other) noexcept
+      : comp(std::move(other.comp)), proj(std::move(other.proj)), alloc(std::move(other.alloc)),
+        head(std::exchange(other.head, nullptr)), tail(std::exchange(other.tail, nullptr)), min(std::exchange(other.min, nullptr)) {}
+
+  /**
+   * @brief Replaces the keys of this heap with the keys of another heap.
+   *
+   * The keys of this heap are destroyed. Like the standard containers, the heap then takes
+   * over the nodes of the other heap if its allocator propagates on move assignment or
+   * compares equal to the allocator of the other heap. Otherwise, e.g. for two
+   * `std::pmr::polymorphic_allocator`s with different memory resources, the keys are moved
+   * one by one into nodes allocated by this heap, which invalidates the handles to the keys
+   * of the other heap. If moving a key throws, the keys not moved yet are lost.
+   *
+   * @note The other heap is left empty.
+   *
+   * The time complexity of this operation is O(1), or O(m) if the keys are moved one by
+   * one, where m is the number of nodes in the other heap, plus the time needed to destroy
+   * the keys of this heap.
+   *
+   * @param other The heap to move from.
+   * @return A reference to this heap.
+   */
+  constexpr UnsortedLinkedHeap &operator=(UnsortedLinkedHeap &&other) noexcept(NodeTraits::propagate_on_container_move_assignment::value || NodeTraits::is_always_equal::value)
+  {
+    if (this == &other)
+    {
+      return *this;
+    }
+
+    destroy_list(std::exchange(head, nullptr));
+    tail = min = nullptr;
+    comp = std::move(other.comp);
+    proj = std::move(other.proj);
+    if (NodeTraits::propagate_on_container_move_assignment::value || alloc == other.alloc)
+    {
+      if constexpr (NodeTraits::propagate_on_container_move_assignment::value)
+      {
+        alloc = std::move(other.alloc);
+      }
+      head = std::exchange(other.head, nullptr);
+      tail = std::exchange(other.tail, nullptr);
+      min = std::exchange(other.min, nullptr);
+    }
+    else
+    {
+      Node *node = std::exchange(other.head, nullptr);
+      other.tail = other.min = nullptr;
+      while (node != nullptr)
+      {
+        Node *next = node->next;
+        emplace(std::move(node->key));
+        other.destroy_node(node);
+        node = next;
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Swaps the keys of this heap with the keys of another heap.
+   *
+   * The comparators and projections are swapped as well, and so are the allocators if they
+   * propagate on swap.
+   *
+   * @pre The allocators of both heaps compare equal, unless they propagate on swap, as for
+   * the standard containers. This is checked by an assertion.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param other The heap to swap with.
+   */
+  constexpr void swap(UnsortedLinkedHeap &other) noexcept
+  {
+    assert(NodeTraits::propagate_on_container_swap::value || alloc == other.alloc);
+    std::swap(comp, other.comp);
+    std::swap(proj, other.proj);
+    if constexpr (NodeTraits::propagate_on_container_swap::value)
     {
-      Node *next = current->next;
-      delete current;
-      current = next;
+      std::swap(alloc, other.alloc);
     }
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(min, other.min);
   }
 
   /**
-   * @brief Inserts a key into the heap.
+   * @brief Swaps the keys of two heaps.
+   */
+  friend constexpr void swap(UnsortedLinkedHeap &a, UnsortedLinkedHeap &b) noexcept
+  {
+    a.swap(b);
+  }
+
+  /**
+   * @brief Constructs a key in place from the given arguments, and inserts it into the heap.
    *
    * This function inserts a new key into the heap. The key is inserted at the end of the
    * linked list, and the minimum key is updated if the new key is smaller than the current
@@ -92,11 +314,14 @@ public:
    *
    * The time complexity of this operation is O(1).
    *
-   * @param key The key to insert into the heap. This key is moved into the heap.
+   * @param args The arguments forwarded to the constructor of the key, which is constructed
+   * directly inside the new node.
+   * @return A handle to the inserted key.
    */
-  constexpr void insert(T key) override
+  template <typename... Args>
+  constexpr handle_type emplace(Args &&...args)
   {
-    Node *node = new Node(std::move(key));
+    Node *node = create_node(std::forward<Args>(args)...);
     if (head == nullptr)
     {
       head = tail = node;
@@ -107,10 +332,36 @@ public:
       node->prev = tail;
       tail = node;
     }
-    if (min == nullptr || node->key < min->key)
+    if (min == nullptr || less(node->key, min->key))
     {
       min = node;
     }
+    return handle_type(node);
+  }
+
+  /**
+   * @brief Inserts a key into the heap and returns a handle to it.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   * @return A handle to the inserted key.
+   */
+  constexpr handle_type push(T key)
+  {
+    return emplace(std::move(key));
+  }
+
+  /**
+   * @brief Inserts a key into the heap.
+   *
+   * The key is moved into the heap by `emplace`, with the same time complexity.
+   *
+   * @param key The key to insert. This key is moved into the heap.
+   */
+  constexpr void insert(T key)
+  {
+    emplace(std::move(key));
   }
 
   /**
@@ -125,7 +376,7 @@ public:
    *
    * @return A reference to the minimum key, or `std::nullopt` if the heap is empty.
    */
-  constexpr std::optional<std::reference_wrapper<const T>> minimum() const override
+  constexpr std::optional<std::reference_wrapper<const T>> minimum() const
   {
     if (min == nullptr)
     {
@@ -145,39 +396,90 @@ public:
    *
    * @return The minimum key in the heap, or `std::nullopt` if the heap is empty.
    */
-  constexpr std::optional<T> extract_min() override
+  constexpr std::optional<T> extract_min()
   {
     if (min == nullptr)
     {
       return std::nullopt;
     }
 
-    T key = std::move(min->key);
-    Node *next = min->next;
-    Node *prev = min->prev;
+    return erase(handle_type(min));
+  }
 
-    if (prev != nullptr) // min is not the head
+  /**
+   * @brief Decreases a key in the heap.
+   *
+   * The key is replaced in its node, and the minimum is updated if the new key is smaller
+   * than the current minimum.
+   *
+   * The time complexity of this operation is O(1).
+   *
+   * @param handle A handle to the key to decrease.
+   * @param key The new key. This key is moved into the heap.
+   * @throws std::invalid_argument If the new key is greater than the current key.
+   */
+  constexpr void decrease_key(handle_type handle, T key)
+  {
+    Node *node = handle.node;
+    if (less(node->key, key))
+    {
+      throw std::invalid_argument("The new key is greater than the current key");
+    }
+    node->key = std::move(key);
+
+    if (less(node->key, min->key))
+    {
+      min = node;
+    }
+  }
+
+  /**
+   * @brief Removes a key from the heap and returns it.
+   *
+   * The node is unlinked from the list. If it held the minimum key, the new minimum must be
+   * searched for in the entire linked list.
+   *
+   * The time complexity of this operation is O(1), or O(n) if the minimum key is removed,
+   * where n is the number of nodes in the heap.
+   *
+   * @param handle A handle to the key to remove. The handle is invalidated.
+   * @return The removed key.
+   */
+  constexpr T erase(handle_type handle)
+  {
+    Node *node = handle.node;
+    T key = std::move(node->key);
+    Node *next = node->next;
+    Node *prev = node->prev;
+
+    if (prev != nullptr) // node is not the head
     {
       prev->next = next;
     }
-    if (next != nullptr) // min is not the tail
+    if (next != nullptr) // node is not the tail
     {
       next->prev = prev;
     }
 
-    if (min == head)
+    if (node == head)
     {
       head = next; // update head
     }
-    if (min == tail)
+    if (node == tail)
     {
       tail = prev; // update tail
     }
 
-    delete min;
-    min = nullptr;
+    if (node == min)
+    {
+      min = nullptr;
+    }
+    destroy_node(node);
 
-    update_min(); // O(n)
+    if (min == nullptr)
+    {
+      update_min(); // O(n)
+    }
 
     return key;
   }
@@ -191,39 +493,40 @@ public:
    *
    * @note The other heap is left empty after the merge.
    *
+   * @pre The allocators of both heaps compare equal, as the nodes of the other heap are
+   * later deallocated by the allocator of this heap.
+   *
    * The time complexity of this operation is O(1), because the other heap is merged
    * into this heap by concatenating the tail of the other heap with the head of this heap.
    *
    * @param other The heap to merge into this heap.
    */
-  constexpr void merge(MergeableHeap<T> &other) override
+  constexpr void merge(UnsortedLinkedHeap &other)
   {
-    UnsortedLinkedHeap<T> &other_heap = static_cast<UnsortedLinkedHeap<T> &>(other);
-
-    if (other_heap.head == nullptr)
+    if (other.head == nullptr)
     {
       return;
     }
 
     if (head == nullptr) // this heap is empty
     {
-      head = other_heap.head;
-      tail = other_heap.tail;
-      min = other_heap.min;
+      head = other.head;
+      tail = other.tail;
+      min = other.min;
     }
     else // this heap is not empty, concatenate the two heaps
     {
-      tail->next = other_heap.head;
-      other_heap.head->prev = tail;
-      tail = other_heap.tail;
+      tail->next = other.head;
+      other.head->prev = tail;
+      tail = other.tail;
 
-      if (other_heap.min->key < min->key)
+      if (less(other.min->key, min->key))
       {
-        min = other_heap.min;
+        min = other.min;
       }
     }
 
-    other_heap.head = other_heap.tail = other_heap.min = nullptr;
+    other.head = other.tail = other.min = nullptr;
   }
 
   /**
@@ -235,7 +538,7 @@ public:
    * The time complexity of this operation is O(n), where n is the number of nodes in the
    * heap.
    */
-  void print() const override
+  void print() const
   {
     if (head == nullptr)
     {
@@ -261,15 +564,133 @@ public:
    * heap, because the minimum key must be extracted n times, and each extraction takes
    * O(n) time.
    */
-  void sort() override
+  void sort()
+  {
+    this->Base::sort(UnsortedLinkedHeap(comp, proj, get_allocator()));
+  }
+
+  /**
+   * @brief Returns a copy of the allocator used by the heap.
+   */
+  constexpr allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(alloc);
+  }
+
+  /**
+   * @brief Returns a copy of the comparator used by the heap.
+   */
+  constexpr Compare key_comp() const
+  {
+    return comp;
+  }
+
+  /**
+   * @brief Returns a copy of the projection used by the heap.
+   */
+  constexpr Projection key_proj() const
   {
-    this->MergeableHeap<T>::sort(UnsortedLinkedHeap<T>{});
+    return proj;
+  }
+
+protected:
+  /**
+   * @brief Inserts a batch of keys into the heap.
+   *
+   * The keys are linked into a chain of new nodes, while the minimum of the batch is
+   * tracked in the same pass. The chain is then concatenated to the end of the list.
+   *
+   * The time complexity of this operation is O(k), where k is the number of keys.
+   *
+   * @param keys The keys to insert into the heap. The keys are moved into the heap.
+   */
+  constexpr void insert_bulk(std::span<T> keys)
+  {
+    if (keys.empty())
+    {
+      return;
+    }
+
+    Node *first = create_node(std::move(keys.front()));
+    Node *last = first;
+    Node *batch_min = first;
+    for (T &key : keys.subspan(1))
+    {
+      Node *node = create_node(std::move(key));
+      node->prev = last;
+      last->next = node;
+      last = node;
+      if (less(node->key, batch_min->key))
+      {
+        batch_min = node;
+      }
+    }
+
+    if (head == nullptr)
+    {
+      head = first;
+    }
+    else
+    {
+      tail->next = first;
+      first->prev = tail;
+    }
+    tail = last;
+
+    if (min == nullptr || less(batch_min->key, min->key))
+    {
+      min = batch_min;
+    }
   }
 
 private:
-  Node *head; ///< A pointer to the first node in the linked list.
-  Node *tail; ///< A pointer to the last node in the linked list.
-  Node *min;  ///< A pointer to the node with the minimum key.
+  [[no_unique_address]] Compare comp;        ///< The comparator used to order the keys.
+  [[no_unique_address]] Projection proj;     ///< The projection applied to the keys before they are compared.
+  [[no_unique_address]] NodeAllocator alloc; ///< The allocator used to allocate the nodes.
+  Node *head;                                ///< A pointer to the first node in the linked list.
+  Node *tail;                                ///< A pointer to the last node in the linked list.
+  Node *min;                                 ///< A pointer to the node with the minimum key.
+
+  /**
+   * @brief Returns whether the key `a` comes before the key `b` in the order of the heap.
+   */
+  constexpr bool less(const T &a, const T &b) const
+  {
+    return std::invoke(comp, std::invoke(proj, a), std::invoke(proj, b));
+  }
+
+  /**
+   * @brief Allocates a new node, and constructs its key in place from the given arguments.
+   */
+  template <typename... Args>
+  constexpr Node *create_node(Args &&...args)
+  {
+    Node *node = NodeTraits::allocate(alloc, 1);
+    NodeTraits::construct(alloc, node, std::in_place, std::forward<Args>(args)...);
+    return node;
+  }
+
+  /**
+   * @brief Destroys and deallocates every node of a null-terminated list.
+   */
+  constexpr void destroy_list(Node *node) noexcept
+  {
+    while (node != nullptr)
+    {
+      Node *next = node->next;
+      destroy_node(node);
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Destroys and deallocates a node.
+   */
+  constexpr void destroy_node(Node *node) noexcept
+  {
+    NodeTraits::destroy(alloc, node);
+    NodeTraits::deallocate(alloc, node, 1);
+  }
 
   void update_min()
   {
@@ -280,7 +701,7 @@ private:
     }
     for (Node *current = head->next; current != nullptr; current = current->next)
     {
-      if (current->key < min->key)
+      if (less(current->key, min->key))
       {
         min = current;
       }
@@ -288,4 +709,13 @@ private:
   }
 }; // class UnsortedLinkedHeap
 
+namespace pmr
+{
+  /**
+   * @brief An `UnsortedLinkedHeap` that allocates its nodes from a `std::pmr::memory_resource`.
+   */
+  template <typename T, typename Compare = std::less<>, typename Projection = std::identity>
+  using UnsortedLinkedHeap = ::UnsortedLinkedHeap<T, Compare, Projection, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
 #endif // SORTED_HEAP_H
\ No newline at end of file